@@ -0,0 +1,82 @@
+#include "BenchmarkFixtures.h"
+
+#include "maxwell/DenseRK4Solver.h"
+#include "maxwell/MaxwellEvolution1D.h"
+#include "maxwell/MaxwellEvolution2D.h"
+#include "maxwell/MaxwellEvolution3D.h"
+
+using namespace maxwell;
+using namespace maxwell::benchmarks;
+using namespace mfem;
+
+// Dimension of the mesh, not Evolution::numberOfMaxDimensions which counts field components.
+template <class Evolution, int Dimension>
+static void BM_EvolutionMult(benchmark::State& state)
+{
+	Problem problem{ Dimension, state };
+	Evolution evolution{ problem.fes, problem.model, problem.opts };
+	Vector in(evolution.Width()), out(evolution.Height());
+	in.Randomize(1);
+
+	const auto bytes{ measureOperatorBytes([&]() { evolution.Mult(in, out); }) };
+	for (auto _ : state) {
+		evolution.Mult(in, out);
+		benchmark::DoNotOptimize(out.GetData());
+		benchmark::ClobberMemory();
+	}
+	state.counters["DOFs"] = evolution.Width();
+	state.counters["DOFs/s"] = perSecond(evolution.Width());
+	state.counters["bytes/s"] = perSecond(bytes);
+}
+
+template <class Evolution, int Dimension>
+static void BM_RK4Step(benchmark::State& state)
+{
+	Problem problem{ Dimension, state };
+	Evolution evolution{ problem.fes, problem.model, problem.opts };
+	DenseRK4Solver solver;
+	solver.Init(evolution);
+	Vector x(evolution.Width());
+	x.Randomize(1);
+	double t{ 0.0 }, dt{ 1e-6 };
+
+	// Four evaluations of the operator plus the vector updates of DenseRK4Solver::Step.
+	const auto multBytes{ measureOperatorBytes([&]() { Vector k(x.Size()); evolution.Mult(x, k); }) };
+	const auto bytes{ 4.0 * multBytes + 23.0 * x.Size() * sizeof(double) };
+	for (auto _ : state) {
+		solver.Step(x, t, dt);
+		benchmark::DoNotOptimize(x.GetData());
+		benchmark::ClobberMemory();
+	}
+	state.counters["DOFs"] = x.Size();
+	state.counters["DOFs/s"] = perSecond(x.Size());
+	state.counters["bytes/s"] = perSecond(bytes);
+}
+
+static const std::vector<int64_t> orders{ 1, 2, 3, 4 };
+
+BENCHMARK_TEMPLATE(BM_EvolutionMult, MaxwellEvolution1D, 1)
+	->ArgNames({ "order", "elements", "type" })
+	->ArgsProduct({ orders, { 64, 512, 4096 }, { tensor } })
+	->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_EvolutionMult, MaxwellEvolution2D, 2)
+	->ArgNames({ "order", "elements", "type" })
+	->ArgsProduct({ orders, { 8, 32, 64 }, { tensor, simplex } })
+	->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_EvolutionMult, MaxwellEvolution3D, 3)
+	->ArgNames({ "order", "elements", "type" })
+	->ArgsProduct({ orders, { 4, 8, 16 }, { tensor, simplex } })
+	->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_RK4Step, MaxwellEvolution1D, 1)
+	->ArgNames({ "order", "elements", "type" })
+	->ArgsProduct({ orders, { 512, 4096 }, { tensor } })
+	->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_RK4Step, MaxwellEvolution2D, 2)
+	->ArgNames({ "order", "elements", "type" })
+	->ArgsProduct({ orders, { 32, 64 }, { tensor, simplex } })
+	->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_RK4Step, MaxwellEvolution3D, 3)
+	->ArgNames({ "order", "elements", "type" })
+	->ArgsProduct({ orders, { 8, 16 }, { tensor, simplex } })
+	->Unit(benchmark::kMillisecond);
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <mfem.hpp>
+
+#include "maxwell/Model.h"
+#include "maxwell/Profiler.h"
+
+namespace maxwell {
+namespace benchmarks {
+
+// Arguments shared by all benchmarks, in this order.
+enum Argument {
+	Order,
+	Elements,
+	ElementType
+};
+
+// Tensor product elements, segments, quadrilaterals or hexahedra.
+const int tensor{ 0 };
+// Simplices, triangles or tetrahedra. Only 2D and 3D.
+const int simplex{ 1 };
+
+inline mfem::Mesh buildMesh(int dimension, int elements, int elementType)
+{
+	using mfem::Element;
+	switch (dimension) {
+	case 1:
+		return mfem::Mesh::MakeCartesian1D(elements, 1.0);
+	case 2:
+		return mfem::Mesh::MakeCartesian2D(elements, elements,
+			elementType == simplex ? Element::Type::TRIANGLE : Element::Type::QUADRILATERAL);
+	default:
+		return mfem::Mesh::MakeCartesian3D(elements, elements, elements,
+			elementType == simplex ? Element::Type::TETRAHEDRON : Element::Type::HEXAHEDRON);
+	}
+}
+
+// Cartesian meshes number their boundaries from 1 to twice the dimension.
+inline AttributeToBoundary buildPECBoundaries(int dimension)
+{
+	AttributeToBoundary res;
+	for (int a = 1; a <= 2 * dimension; a++) {
+		res[a] = BdrCond::PEC;
+	}
+	return res;
+}
+
+/** Model and DG space of a benchmark, built before timing starts. Spaces
+	point to the mesh of the model, so problems are not copied nor moved.
+	*/
+struct Problem {
+	Problem(int dimension, const benchmark::State& state) :
+		mesh{ buildMesh(dimension, (int) state.range(Elements), (int) state.range(ElementType)) },
+		model{ mesh, AttributeToMaterial{}, buildPECBoundaries(dimension) },
+		fec{ (int) state.range(Order), dimension, mfem::BasisType::GaussLobatto },
+		fes{ &model.getMesh(), &fec }
+	{}
+	Problem(const Problem&) = delete;
+	Problem& operator=(const Problem&) = delete;
+
+	mfem::Mesh mesh;
+	Model model;
+	mfem::DG_FECollection fec;
+	mfem::FiniteElementSpace fes;
+	MaxwellEvolOptions opts;
+};
+
+// Values per second, for values processed once per iteration.
+inline benchmark::Counter perSecond(double valuePerIteration)
+{
+	return benchmark::Counter(valuePerIteration, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+// Bytes the operator groups estimate for one call of f, see StateLayout::addMult.
+template <typename F>
+double measureOperatorBytes(F&& f)
+{
+	Profiler profiler;
+	ProfilerScope scope{ profiler };
+	f();
+	return profiler.getOperatorBytes();
+}
+
+}
+}
@@ -0,0 +1,116 @@
+#include "BenchmarkFixtures.h"
+
+#include "maxwell/MaxwellDefs.h"
+#include "maxwell/mfemExtension/BilinearIntegrators.h"
+
+using namespace maxwell;
+using namespace maxwell::benchmarks;
+using namespace mfem;
+
+// Operators of the evolutions, as named in their members, all along x.
+static FiniteElementOperator buildOperator(const OperatorGroup& group, Problem& p)
+{
+	switch (group) {
+	case OperatorGroup::MS:
+		return buildByMult(*buildInverseMassMatrix(H, p.model, p.fes), *buildDerivativeOperator(X, p.fes), p.fes);
+	case OperatorGroup::MFN:
+		return buildByMult(*buildInverseMassMatrix(H, p.model, p.fes), *buildFluxOperator(E, { X }, p.model, p.fes), p.fes);
+	case OperatorGroup::MFNN:
+		return buildByMult(*buildInverseMassMatrix(H, p.model, p.fes), *buildFluxOperator(H, { X, X }, p.model, p.fes), p.fes);
+	default:
+		return buildByMult(*buildInverseMassMatrix(H, p.model, p.fes), *buildPenaltyOperator(H, {}, p.model, p.fes, p.opts), p.fes);
+	}
+}
+
+// Product of one operator with one field component, as in StateLayout::addMult for a single term.
+template <int Dimension, OperatorGroup Group>
+static void BM_OperatorSpMV(benchmark::State& state)
+{
+	Problem problem{ Dimension, state };
+	const auto op{ buildOperator(Group, problem) };
+	const auto& A{ op->SpMat() };
+	Vector in(A.Width()), out(A.Height());
+	in.Randomize(1);
+
+	for (auto _ : state) {
+		A.Mult(in, out);
+		benchmark::DoNotOptimize(out.GetData());
+		benchmark::ClobberMemory();
+	}
+	const double nnz(A.NumNonZeroElems());
+	const auto bytes{
+		nnz * (sizeof(double) + sizeof(int)) + (A.Height() + 1.0) * sizeof(int) +
+		(A.Width() + A.Height()) * sizeof(double)
+	};
+	state.counters["DOFs"] = A.Height();
+	state.counters["nnz"] = nnz;
+	state.counters["DOFs/s"] = perSecond(A.Height());
+	state.counters["bytes/s"] = perSecond(bytes);
+}
+
+// Face matrices of the flux integrator on every interior face, the bulk of the assembly of MFN, MFNN and MP.
+template <int Dimension, int NormalTerms>
+static void BM_AssembleFaceMatrix(benchmark::State& state)
+{
+	Problem problem{ Dimension, state };
+	auto& mesh{ problem.model.getMesh() };
+	const std::vector<Direction> dirTerms(NormalTerms, X);
+	mfemExtension::MaxwellDGTraceJumpIntegrator integrator{ dirTerms, 0.5 };
+	DenseMatrix elmat;
+
+	int faces{ 0 };
+	for (auto _ : state) {
+		faces = 0;
+		for (int f = 0; f < mesh.GetNumFaces(); f++) {
+			auto* T{ mesh.GetInteriorFaceTransformations(f) };
+			if (T == nullptr) {
+				continue;
+			}
+			integrator.AssembleFaceMatrix(*problem.fes.GetFE(T->Elem1No), *problem.fes.GetFE(T->Elem2No), *T, elmat);
+			benchmark::DoNotOptimize(elmat.Data());
+			faces++;
+		}
+	}
+	state.counters["faces"] = faces;
+	state.counters["faces/s"] = perSecond(faces);
+	// Both elements of each face contribute their DoFs.
+	state.counters["DOFs/s"] = perSecond(2.0 * faces * problem.fes.GetFE(0)->GetDof());
+	state.counters["bytes/s"] = perSecond(faces * elmat.Height() * elmat.Width() * sizeof(double));
+}
+
+static const std::vector<int64_t> orders{ 1, 2, 3, 4 };
+
+#define MAXWELL_SPMV_BENCHMARKS(group) \
+	BENCHMARK_TEMPLATE(BM_OperatorSpMV, 1, group) \
+		->ArgNames({ "order", "elements", "type" }) \
+		->ArgsProduct({ orders, { 512, 4096 }, { tensor } }); \
+	BENCHMARK_TEMPLATE(BM_OperatorSpMV, 2, group) \
+		->ArgNames({ "order", "elements", "type" }) \
+		->ArgsProduct({ orders, { 32, 64 }, { tensor, simplex } }); \
+	BENCHMARK_TEMPLATE(BM_OperatorSpMV, 3, group) \
+		->ArgNames({ "order", "elements", "type" }) \
+		->ArgsProduct({ orders, { 8, 16 }, { tensor, simplex } })
+
+MAXWELL_SPMV_BENCHMARKS(OperatorGroup::MS);
+MAXWELL_SPMV_BENCHMARKS(OperatorGroup::MFN);
+MAXWELL_SPMV_BENCHMARKS(OperatorGroup::MFNN);
+MAXWELL_SPMV_BENCHMARKS(OperatorGroup::MP);
+
+// Penalties, fluxes along one normal and normal-normal fluxes.
+BENCHMARK_TEMPLATE(BM_AssembleFaceMatrix, 2, 0)
+	->ArgNames({ "order", "elements", "type" })
+	->ArgsProduct({ orders, { 32 }, { tensor, simplex } });
+BENCHMARK_TEMPLATE(BM_AssembleFaceMatrix, 2, 1)
+	->ArgNames({ "order", "elements", "type" })
+	->ArgsProduct({ orders, { 32 }, { tensor, simplex } });
+BENCHMARK_TEMPLATE(BM_AssembleFaceMatrix, 2, 2)
+	->ArgNames({ "order", "elements", "type" })
+	->ArgsProduct({ orders, { 32 }, { tensor, simplex } });
+BENCHMARK_TEMPLATE(BM_AssembleFaceMatrix, 3, 1)
+	->ArgNames({ "order", "elements", "type" })
+	->ArgsProduct({ orders, { 8 }, { tensor, simplex } })
+	->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_AssembleFaceMatrix, 3, 2)
+	->ArgNames({ "order", "elements", "type" })
+	->ArgsProduct({ orders, { 8 }, { tensor, simplex } })
+	->Unit(benchmark::kMillisecond);
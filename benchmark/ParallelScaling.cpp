@@ -0,0 +1,131 @@
+#include <mfem.hpp>
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "maxwell/ParSolver.h"
+
+using namespace maxwell;
+using namespace mfem;
+
+/** Strong and weak scaling tables of ParSolver.
+	A single run on N ranks measures all the rank counts 1, 2, 4, ... up to
+	N, each on a communicator split from the world, so efficiencies are
+	relative to one rank of the same machine and allocation:
+		mpirun -np <N> maxwell_scaling [elements] [steps]
+	Strong scaling solves a mesh of 4 elements x 4 elements quadrilaterals
+	with every rank count, weak scaling keeps elements x elements per rank.
+	Rank 0 prints both tables in Markdown.
+	*/
+
+namespace {
+
+struct Row {
+	int ranks;
+	double dofs;
+	double secondsPerStep;
+};
+
+Model buildModel(int nx, int ny)
+{
+	return Model(
+		Mesh::MakeCartesian2D(nx, ny, Element::Type::QUADRILATERAL),
+		AttributeToMaterial{},
+		AttributeToBoundary{ {1, BdrCond::PEC}, {2, BdrCond::PEC}, {3, BdrCond::PEC}, {4, BdrCond::PEC} }
+	);
+}
+
+Sources buildInitialField()
+{
+	Sources res;
+	res.push_back(std::make_unique<GaussianInitialField>(E, Z, 0.1, 1.0, Vector({ 0.5, 0.5 })));
+	return res;
+}
+
+// Seconds per step of the slowest rank of the communicator.
+Row measure(MPI_Comm comm, int nx, int ny, int steps)
+{
+	const double dt{ 1e-4 };
+	ParSolver solver{ comm, buildModel(nx, ny), Probes{}, buildInitialField(), SolverOptions{}.setTimeStep(dt).setFinalTime(dt * steps) };
+
+	MPI_Barrier(comm);
+	const auto start{ MPI_Wtime() };
+	solver.run();
+	const auto local{ MPI_Wtime() - start };
+	double elapsed;
+	MPI_Allreduce(&local, &elapsed, 1, MPI_DOUBLE, MPI_MAX, comm);
+
+	// ParSolver::run also steps when it reaches the final time.
+	return { solver.getNumberOfRanks(), 6.0 * solver.getGlobalNDofs(), elapsed / (steps + 1) };
+}
+
+void printTable(const std::string& title, const std::vector<Row>& rows, bool isStrong)
+{
+	const auto& reference{ rows.front() };
+	std::cout << "\n" << title << "\n\n"
+		<< "| ranks | DoFs | DoFs/rank | s/step | DoFs/s | speedup | efficiency |\n"
+		<< "|------:|-----:|----------:|-------:|-------:|--------:|-----------:|\n";
+	for (const auto& row : rows) {
+		// Strong scaling compares times of the same problem, weak scaling
+		// compares throughputs, which should grow with the ranks.
+		const auto speedup{ isStrong ?
+			reference.secondsPerStep / row.secondsPerStep :
+			(row.dofs / row.secondsPerStep) / (reference.dofs / reference.secondsPerStep) };
+		std::cout << std::setprecision(4)
+			<< "| " << row.ranks
+			<< " | " << row.dofs
+			<< " | " << row.dofs / row.ranks
+			<< " | " << row.secondsPerStep
+			<< " | " << row.dofs / row.secondsPerStep
+			<< " | " << speedup
+			<< " | " << 100.0 * speedup / row.ranks << "% |\n";
+	}
+	std::cout << std::flush;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	Mpi::Init(argc, argv);
+	Hypre::Init();
+	const auto elements{ argc > 1 ? std::atoi(argv[1]) : 32 };
+	const auto steps{ argc > 2 ? std::atoi(argv[2]) : 200 };
+	if (elements <= 0 || steps <= 0) {
+		std::cerr << "Usage: maxwell_scaling [elements] [steps]" << std::endl;
+		return 1;
+	}
+
+	const auto rank{ Mpi::WorldRank() };
+	const auto size{ Mpi::WorldSize() };
+	std::vector<int> rankCounts;
+	for (int n = 1; n < size; n *= 2) {
+		rankCounts.push_back(n);
+	}
+	rankCounts.push_back(size);
+
+	std::vector<Row> strong, weak;
+	for (const auto& n : rankCounts) {
+		MPI_Comm comm;
+		MPI_Comm_split(MPI_COMM_WORLD, rank < n ? 0 : MPI_UNDEFINED, rank, &comm);
+		if (comm != MPI_COMM_NULL) {
+			strong.push_back(measure(comm, 4 * elements, 4 * elements, steps));
+			weak.push_back(measure(comm, elements * n, elements, steps));
+			MPI_Comm_free(&comm);
+		}
+		MPI_Barrier(MPI_COMM_WORLD);
+	}
+
+	if (rank == 0) {
+		std::stringstream strongTitle, weakTitle;
+		strongTitle << "Strong scaling, " << 4 * elements << " x " << 4 * elements << " elements, " << steps << " steps";
+		weakTitle << "Weak scaling, " << elements << " x " << elements << " elements per rank, " << steps << " steps";
+		printTable(strongTitle.str(), strong, true);
+		printTable(weakTitle.str(), weak, false);
+	}
+	return 0;
+}
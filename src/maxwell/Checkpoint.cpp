@@ -0,0 +1,183 @@
+#include "Checkpoint.h"
+
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace maxwell {
+
+static const char checkpointMagic[8]{ 'M', 'X', 'W', 'L', 'C', 'K', 'P', 'T' };
+
+void BinaryWriter::write(const void* data, std::size_t size)
+{
+	const auto* bytes{ static_cast<const char*>(data) };
+	buffer_.insert(buffer_.end(), bytes, bytes + size);
+}
+
+void BinaryWriter::write(const std::vector<double>& v)
+{
+	write<std::uint64_t>(v.size());
+	write(v.data(), v.size() * sizeof(double));
+}
+
+void BinaryWriter::write(const mfem::Vector& v)
+{
+	write<std::uint64_t>(v.Size());
+	write(v.GetData(), v.Size() * sizeof(double));
+}
+
+void BinaryWriter::align(std::size_t alignment)
+{
+	buffer_.resize((buffer_.size() + alignment - 1) / alignment * alignment, 0);
+}
+
+const char* BinaryReader::view(std::size_t size)
+{
+	if (pos_ + size > size_) {
+		throw std::runtime_error("Unexpected end of binary data.");
+	}
+	const auto* res{ data_ + pos_ };
+	pos_ += size;
+	return res;
+}
+
+void BinaryReader::read(void* data, std::size_t size)
+{
+	std::memcpy(data, view(size), size);
+}
+
+void BinaryReader::align(std::size_t alignment)
+{
+	view((pos_ + alignment - 1) / alignment * alignment - pos_);
+}
+
+std::vector<double> BinaryReader::readVector()
+{
+	std::vector<double> res(read<std::uint64_t>());
+	read(res.data(), res.size() * sizeof(double));
+	return res;
+}
+
+void BinaryReader::read(mfem::Vector& v)
+{
+	if (read<std::uint64_t>() != (std::uint64_t) v.Size()) {
+		throw std::runtime_error("Stored vector size does not match.");
+	}
+	read(v.GetData(), v.Size() * sizeof(double));
+}
+
+void writeCheckpointHeader(BinaryWriter& w, std::uint64_t hash)
+{
+	w.write(checkpointMagic, sizeof(checkpointMagic));
+	w.write(checkpointVersion);
+	w.write<std::uint32_t>(0);
+	w.write(hash);
+}
+
+// Next to the final file, so that renaming it does not cross file systems.
+static std::string buildTemporaryFilename(const std::string& filename)
+{
+	static std::atomic<unsigned> counter{ 0 };
+#ifdef _WIN32
+	const auto pid{ (unsigned long) GetCurrentProcessId() };
+#else
+	const auto pid{ (unsigned long) getpid() };
+#endif
+	return filename + "." + std::to_string(pid) + "." + std::to_string(counter++) + ".tmp";
+}
+
+void saveToFile(const BinaryWriter& w, const std::string& filename)
+{
+	// Each writer has its own temporary file, so concurrent writers of the
+	// same file never truncate each other and the last rename wins.
+	const auto tmp{ buildTemporaryFilename(filename) };
+	{
+		std::ofstream out{ tmp, std::ios::binary | std::ios::trunc };
+		out.write(w.getBuffer().data(), w.getBuffer().size());
+		if (!out) {
+			out.close();
+			std::remove(tmp.c_str());
+			throw std::runtime_error("Could not write file " + tmp);
+		}
+	}
+	// Replaces the previous file atomically, it is never absent nor partially written.
+#ifdef _WIN32
+	const auto renamed{ MoveFileExA(tmp.c_str(), filename.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0 };
+#else
+	const auto renamed{ std::rename(tmp.c_str(), filename.c_str()) == 0 };
+#endif
+	if (!renamed) {
+		std::remove(tmp.c_str());
+		throw std::runtime_error("Could not rename " + tmp + " to " + filename);
+	}
+}
+
+BinaryReader openCheckpoint(const MappedFile& file, std::uint64_t hash)
+{
+	BinaryReader r{ file.data(), file.size() };
+	
+	char magic[sizeof(checkpointMagic)];
+	r.read(magic, sizeof(magic));
+	if (std::memcmp(magic, checkpointMagic, sizeof(magic)) != 0) {
+		throw std::runtime_error(file.getFilename() + " is not a checkpoint file.");
+	}
+	if (r.read<std::uint32_t>() != checkpointVersion) {
+		throw std::runtime_error(file.getFilename() + " has an unsupported checkpoint version.");
+	}
+	r.read<std::uint32_t>();
+	if (r.read<std::uint64_t>() != hash) {
+		throw std::runtime_error(file.getFilename() + " was written for a different mesh or options.");
+	}
+	return r;
+}
+
+static volatile std::sig_atomic_t checkpointRequest{ 0 };
+
+extern "C" void handleCheckpointSignal(int signal)
+{
+	if (signal == SIGTERM) {
+		checkpointRequest = static_cast<int>(CheckpointRequest::CheckpointAndStop);
+	}
+	else if (checkpointRequest == 0) {
+		checkpointRequest = static_cast<int>(CheckpointRequest::Checkpoint);
+	}
+}
+
+CheckpointSignalHandlers::CheckpointSignalHandlers()
+{
+	previousTerm_ = std::signal(SIGTERM, handleCheckpointSignal);
+#ifdef SIGUSR1
+	previousUsr1_ = std::signal(SIGUSR1, handleCheckpointSignal);
+#endif
+}
+
+CheckpointSignalHandlers::~CheckpointSignalHandlers()
+{
+	if (previousTerm_ != SIG_ERR) {
+		std::signal(SIGTERM, previousTerm_);
+	}
+#ifdef SIGUSR1
+	if (previousUsr1_ != SIG_ERR) {
+		std::signal(SIGUSR1, previousUsr1_);
+	}
+#endif
+}
+
+CheckpointRequest takeCheckpointRequest()
+{
+	const auto res{ static_cast<CheckpointRequest>(checkpointRequest) };
+	checkpointRequest = 0;
+	return res;
+}
+
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <mfem.hpp>
+
+#include "MappedFile.h"
+
+namespace maxwell {
+
+/** Sequential in memory serialization of trivially copyable values.
+	The whole state is gathered here first so it is stored with a single
+	write.
+	*/
+class BinaryWriter {
+public:
+	void write(const void* data, std::size_t size);
+
+	template <class T>
+	void write(const T& v)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be written.");
+		write(&v, sizeof(T));
+	}
+
+	void write(const std::vector<double>&);
+	void write(const mfem::Vector&);
+	// Pads with zeros up to a multiple of the alignment.
+	void align(std::size_t alignment);
+
+	const std::vector<char>& getBuffer() const { return buffer_; }
+
+private:
+	std::vector<char> buffer_;
+};
+
+/** Sequential deserialization from a memory block, usually a MappedFile. 
+	Reading past the end of the block throws.
+	*/
+class BinaryReader {
+public:
+	BinaryReader(const char* data, std::size_t size) :
+		data_{ data },
+		size_{ size }
+	{}
+
+	void read(void* data, std::size_t size);
+
+	template <class T>
+	T read()
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be read.");
+		T res;
+		read(&res, sizeof(T));
+		return res;
+	}
+
+	std::vector<double> readVector();
+	// Reads into a vector of the already expected size.
+	void read(mfem::Vector&);
+	void align(std::size_t alignment);
+	// Returns the current position of the block and skips size bytes, without copying.
+	const char* view(std::size_t size);
+
+	std::size_t tell() const { return pos_; }
+
+private:
+	const char* data_;
+	std::size_t size_;
+	std::size_t pos_{ 0 };
+};
+
+/** Versioned checkpoint files.
+	A checkpoint is a fixed header followed by the state written by the
+	solver. The header carries a magic string, the format version and the
+	hash of the configuration which produced it. Files are written to a
+	temporary name and renamed, so an interrupted write never replaces the
+	last valid checkpoint.
+	*/
+static const std::uint32_t checkpointVersion{ 1 };
+
+void writeCheckpointHeader(BinaryWriter&, std::uint64_t hash);
+void saveToFile(const BinaryWriter&, const std::string& filename);
+
+// Validates the header of a mapped checkpoint and returns a reader placed after it.
+BinaryReader openCheckpoint(const MappedFile&, std::uint64_t hash);
+
+enum class CheckpointRequest {
+	None,
+	Checkpoint,
+	CheckpointAndStop
+};
+
+/** SIGUSR1 requests a checkpoint, SIGTERM a checkpoint and the end of the run.
+	The handlers are installed while an instance lives, the previous ones
+	are restored on destruction.
+	*/
+class CheckpointSignalHandlers {
+public:
+	using Handler = void (*)(int);
+
+	CheckpointSignalHandlers();
+	~CheckpointSignalHandlers();
+	CheckpointSignalHandlers(const CheckpointSignalHandlers&) = delete;
+	CheckpointSignalHandlers& operator=(const CheckpointSignalHandlers&) = delete;
+
+private:
+	Handler previousTerm_{ SIG_ERR };
+	Handler previousUsr1_{ SIG_ERR };
+};
+
+// Returns the pending request and clears it.
+CheckpointRequest takeCheckpointRequest();
+
+}
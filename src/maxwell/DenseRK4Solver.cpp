@@ -0,0 +1,100 @@
+#include "DenseRK4Solver.h"
+#include "MemoryPlacement.h"
+#include "Profiler.h"
+
+namespace maxwell {
+
+using namespace mfem;
+
+DenseRK4Solver::DenseRK4Solver(const StateLayout& layout, const MemoryPlacementOptions& placement) :
+	layout_{ &layout },
+	placement_{ placement }
+{}
+
+void DenseRK4Solver::allocate(Vector& v, int size) const
+{
+	if (layout_ && placement_.firstTouch) {
+		allocateByFirstTouch(v, size, *layout_, placement_.hugePages);
+	}
+	else {
+		v.SetSize(size);
+	}
+}
+
+void DenseRK4Solver::Init(TimeDependentOperator& f)
+{
+	ODESolver::Init(f);
+	const auto n{ f.Width() };
+	allocate(y0_, n);
+	allocate(z_, n);
+	for (auto& k : k_) {
+		allocate(k, n);
+	}
+	h_ = 0.0;
+}
+
+void DenseRK4Solver::evaluate(double t, const Vector& x, Vector& k) const
+{
+	// The traffic of Mult is the one estimated by the operator groups it runs.
+	const auto operatorBytes{ Profiler::current().getOperatorBytes() };
+	ScopedTimer timer{ ProfiledRegion::Mult, (double) x.Size() };
+	f->SetTime(t);
+	f->Mult(x, k);
+	timer.addBytes(Profiler::current().getOperatorBytes() - operatorBytes);
+}
+
+void DenseRK4Solver::stage(const Vector& x, double a, const Vector& k, Vector& z) const
+{
+	ScopedTimer timer{ ProfiledRegion::RKUpdate, (double) x.Size(), 3.0 * x.Size() * sizeof(double) };
+	add(x, a, k, z);
+}
+
+void DenseRK4Solver::Step(Vector& x, double& t, double& dt)
+{
+	{
+		ScopedTimer timer{ ProfiledRegion::RKUpdate, (double) x.Size(), 2.0 * x.Size() * sizeof(double) };
+		y0_ = x;
+	}
+	t0_ = t;
+	h_ = dt;
+
+	evaluate(t, x, k_[0]);
+
+	stage(x, dt / 2.0, k_[0], z_);
+	evaluate(t + dt / 2.0, z_, k_[1]);
+
+	stage(x, dt / 2.0, k_[1], z_);
+	evaluate(t + dt / 2.0, z_, k_[2]);
+
+	stage(x, dt, k_[2], z_);
+	evaluate(t + dt, z_, k_[3]);
+
+	{
+		ScopedTimer timer{ ProfiledRegion::RKUpdate, (double) x.Size(), 12.0 * x.Size() * sizeof(double) };
+		x.Add(dt / 6.0, k_[0]);
+		x.Add(dt / 3.0, k_[1]);
+		x.Add(dt / 3.0, k_[2]);
+		x.Add(dt / 6.0, k_[3]);
+	}
+	t += dt;
+}
+
+void DenseRK4Solver::interpolate(double t, Vector& x) const
+{
+	assert(hasStep());
+	const auto th{ (t - t0_) / h_ };
+	const auto th2{ th * th };
+	const auto th3{ th2 * th };
+
+	const double b1{ th - 1.5 * th2 + 2.0 / 3.0 * th3 };
+	const double b23{ th2 - 2.0 / 3.0 * th3 };
+	const double b4{ -0.5 * th2 + 2.0 / 3.0 * th3 };
+
+	x = y0_;
+	x.Add(h_ * b1, k_[0]);
+	x.Add(h_ * b23, k_[1]);
+	x.Add(h_ * b23, k_[2]);
+	x.Add(h_ * b4, k_[3]);
+}
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <mfem.hpp>
+
+#include "StateLayout.h"
+
+namespace maxwell {
+
+/** Classical fourth order Runge-Kutta solver with dense output.
+	The stages of the last step are kept so the solution can be evaluated at
+	any time inside that step with the third order continuous extension of
+	the method, without additional evaluations of the operator.
+	*/
+class DenseRK4Solver : public mfem::ODESolver {
+public:
+	DenseRK4Solver() = default;
+	// Stages are placed by first touch with the partition of the layout, which must outlive the solver.
+	DenseRK4Solver(const StateLayout&, const MemoryPlacementOptions&);
+
+	void Init(mfem::TimeDependentOperator& f) override;
+	void Step(mfem::Vector& x, double& t, double& dt) override;
+
+	bool hasStep() const { return h_ > 0.0; }
+	double getStepStartTime() const { return t0_; }
+	double getStepEndTime() const { return t0_ + h_; }
+
+	void interpolate(double t, mfem::Vector& x) const;
+
+private:
+	mfem::Vector y0_, z_;
+	std::array<mfem::Vector, 4> k_;
+	double t0_{ 0.0 }, h_{ 0.0 };
+
+	const StateLayout* layout_{ nullptr };
+	MemoryPlacementOptions placement_;
+
+	void allocate(mfem::Vector&, int size) const;
+	// k = f(t, x), timed as Mult.
+	void evaluate(double t, const mfem::Vector& x, mfem::Vector& k) const;
+	// z = x + a k, timed as RKUpdate.
+	void stage(const mfem::Vector& x, double a, const mfem::Vector& k, mfem::Vector& z) const;
+};
+
+}
@@ -0,0 +1,94 @@
+#include "DispersiveMedia.h"
+
+namespace maxwell {
+
+using namespace mfem;
+
+DispersiveMedia::DispersiveMedia(
+	FiniteElementSpace& fes, 
+	const Model& model, 
+	const std::vector<Direction>& components, 
+	int auxiliaryOffset,
+	const StateLayout& layout) :
+	fes_{ fes },
+	layout_{ layout },
+	components_{ components },
+	auxiliaryOffset_{ auxiliaryOffset }
+{
+	std::map<Attribute, int> attToPoles;
+	for (const auto& kv : model.getAttributeToMaterial()) {
+		const auto& mat{ kv.second };
+		if (!mat.isDispersive()) {
+			continue;
+		}
+		attToPoles.emplace(kv.first, (int) poles_.size());
+		poles_.push_back({ mat.getPermittivity(), mat.getDebyePoles(), mat.getDrudePoles(), mat.getLorentzPoles() });
+	}
+
+	const auto& mesh{ *fes_.GetMesh() };
+	Array<int> elemDofs;
+	for (int e = 0; e < mesh.GetNE(); e++) {
+		const auto it{ attToPoles.find(mesh.GetAttribute(e)) };
+		if (it == attToPoles.end()) {
+			continue;
+		}
+		const auto& p{ poles_[it->second] };
+		const auto states{ (int) (p.debye.size() + p.drude.size() + 2 * p.lorentz.size()) };
+		fes_.GetElementDofs(e, elemDofs);
+		for (const auto& dof : elemDofs) {
+			dofs_.push_back(dof);
+			dofPoles_.push_back(it->second);
+			dofStates_.push_back(statesPerComponent_);
+			statesPerComponent_ += states;
+		}
+	}
+}
+
+bool DispersiveMedia::isDispersive(const Model& model)
+{
+	for (const auto& kv : model.getAttributeToMaterial()) {
+		if (kv.second.isDispersive()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void DispersiveMedia::addTerms(const Vector& in, Vector& out) const
+{
+	for (std::size_t c{ 0 }; c < components_.size(); c++) {
+		const auto component{ getComponent(fes_.GetMesh()->Dimension(), E, components_[c]) };
+		const auto* x{ in.GetData() + auxiliaryOffset_ + c * statesPerComponent_ };
+		auto* dx{ out.GetData() + auxiliaryOffset_ + c * statesPerComponent_ };
+
+		for (std::size_t i{ 0 }; i < dofs_.size(); i++) {
+			const auto& p{ poles_[dofPoles_[i]] };
+			const auto index{ layout_.index(component, dofs_[i]) };
+			const auto field{ in[index] };
+			auto s{ dofStates_[i] };
+			double current{ 0.0 };
+			for (const auto& pole : p.debye) {
+				const auto J{ (pole.deltaEpsilon * field - x[s]) / pole.relaxationTime };
+				dx[s++] = J;
+				current += J;
+			}
+			for (const auto& pole : p.drude) {
+				const auto J{ x[s] };
+				dx[s++] = pole.plasmaFrequency * pole.plasmaFrequency * field - pole.collisionFrequency * J;
+				current += J;
+			}
+			for (const auto& pole : p.lorentz) {
+				const auto w02{ pole.resonanceFrequency * pole.resonanceFrequency };
+				const auto P{ x[s] };
+				const auto J{ x[s + 1] };
+				dx[s] = J;
+				dx[s + 1] = pole.deltaEpsilon * w02 * field - w02 * P - pole.damping * J;
+				s += 2;
+				current += J;
+			}
+			out[index] -= current / p.epsilon;
+		}
+	}
+}
+
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <mfem.hpp>
+
+#include "Model.h"
+#include "StateLayout.h"
+
+namespace maxwell {
+
+/** Auxiliary differential equations of dispersive materials.
+	Poles of the materials contribute polarization currents J_p to
+		eps_inf dE/dt = curl H - sum_p J_p,
+	with states
+		Debye:   dP/dt = (deltaEps E - P) / tau, J = dP/dt,
+		Drude:   dJ/dt = wp^2 E - collisionFrequency J,
+		Lorentz: dP/dt = J, dJ/dt = deltaEps w0^2 (E - P / deltaEps) - damping J.
+	States only exist for the DoFs of elements with dispersive materials and
+	for the electric field components evolved in the dimension. They are
+	stored after the given offset of the state vector and updated, together
+	with their contribution to dE/dt, in a single pass over those DoFs.
+	*/
+class DispersiveMedia {
+public:
+	DispersiveMedia(mfem::FiniteElementSpace&, const Model&, const std::vector<Direction>& components, int auxiliaryOffset, const StateLayout&);
+
+	static bool isDispersive(const Model&);
+
+	int getNumberOfAuxiliaryDOFs() const { return (int) components_.size() * statesPerComponent_; }
+
+	void addTerms(const mfem::Vector& in, mfem::Vector& out) const;
+
+private:
+	struct Poles {
+		double epsilon;
+		std::vector<DebyePole> debye;
+		std::vector<DrudePole> drude;
+		std::vector<LorentzPole> lorentz;
+	};
+
+	mfem::FiniteElementSpace& fes_;
+	const StateLayout& layout_;
+	std::vector<Direction> components_;
+	int auxiliaryOffset_;
+
+	std::vector<Poles> poles_;
+	std::vector<int> dofs_, dofPoles_, dofStates_;
+	int statesPerComponent_{ 0 };
+};
+
+}
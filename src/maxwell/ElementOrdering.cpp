@@ -0,0 +1,166 @@
+#include "ElementOrdering.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <queue>
+
+namespace maxwell {
+
+using namespace mfem;
+
+static std::vector<Vector> buildElementCenters(Mesh& mesh)
+{
+	std::vector<Vector> res(mesh.GetNE());
+	for (int e = 0; e < mesh.GetNE(); e++) {
+		mesh.GetElementCenter(e, res[e]);
+	}
+	return res;
+}
+
+// Inverts a list of old indices in new order.
+static Array<int> toOrdering(const std::vector<int>& order)
+{
+	Array<int> res((int) order.size());
+	for (int i = 0; i < (int) order.size(); i++) {
+		res[order[i]] = i;
+	}
+	return res;
+}
+
+static std::vector<int> sortByCoordinate(Mesh& mesh)
+{
+	const auto centers{ buildElementCenters(mesh) };
+	std::vector<int> res(mesh.GetNE());
+	std::iota(res.begin(), res.end(), 0);
+	std::stable_sort(res.begin(), res.end(), [&](int a, int b) { return centers[a][0] < centers[b][0]; });
+	return res;
+}
+
+static std::vector<int> sortByMortonCode(Mesh& mesh)
+{
+	const auto centers{ buildElementCenters(mesh) };
+	const auto dim{ mesh.SpaceDimension() };
+	const auto bits{ 63 / dim };
+
+	std::vector<double> lo(dim, std::numeric_limits<double>::max()), hi(dim, std::numeric_limits<double>::lowest());
+	for (const auto& c : centers) {
+		for (int d = 0; d < dim; d++) {
+			lo[d] = std::min(lo[d], c[d]);
+			hi[d] = std::max(hi[d], c[d]);
+		}
+	}
+
+	std::vector<std::uint64_t> codes(centers.size(), 0);
+	const auto cells{ double((std::uint64_t(1) << bits) - 1) };
+	for (std::size_t e{ 0 }; e < centers.size(); e++) {
+		for (int d = 0; d < dim; d++) {
+			const auto extent{ hi[d] - lo[d] };
+			const auto q{ extent > 0.0 ? std::uint64_t((centers[e][d] - lo[d]) / extent * cells) : 0 };
+			for (int b = 0; b < bits; b++) {
+				codes[e] |= ((q >> b) & 1) << (b * dim + d);
+			}
+		}
+	}
+
+	std::vector<int> res(centers.size());
+	std::iota(res.begin(), res.end(), 0);
+	std::stable_sort(res.begin(), res.end(), [&](int a, int b) { return codes[a] < codes[b]; });
+	return res;
+}
+
+static std::vector<int> sortByReverseCuthillMcKee(Mesh& mesh)
+{
+	const auto& adj{ mesh.ElementToElementTable() };
+	const auto ne{ mesh.GetNE() };
+	auto degree = [&](int e) { return adj.RowSize(e); };
+
+	std::vector<int> byDegree(ne);
+	std::iota(byDegree.begin(), byDegree.end(), 0);
+	std::stable_sort(byDegree.begin(), byDegree.end(), [&](int a, int b) { return degree(a) < degree(b); });
+
+	std::vector<bool> visited(ne, false);
+	std::vector<int> res, neighbours;
+	res.reserve(ne);
+	// Each connected component starts from an element of minimum degree.
+	for (const auto& start : byDegree) {
+		if (visited[start]) {
+			continue;
+		}
+		visited[start] = true;
+		std::queue<int> queue;
+		queue.push(start);
+		while (!queue.empty()) {
+			const auto e{ queue.front() };
+			queue.pop();
+			res.push_back(e);
+
+			neighbours.clear();
+			for (int k = 0; k < adj.RowSize(e); k++) {
+				const auto n{ adj.GetRow(e)[k] };
+				if (!visited[n]) {
+					visited[n] = true;
+					neighbours.push_back(n);
+				}
+			}
+			std::stable_sort(neighbours.begin(), neighbours.end(), [&](int a, int b) { return degree(a) < degree(b); });
+			for (const auto& n : neighbours) {
+				queue.push(n);
+			}
+		}
+	}
+	std::reverse(res.begin(), res.end());
+	return res;
+}
+
+int getElementBandwidth(Mesh& mesh)
+{
+	const auto& adj{ mesh.ElementToElementTable() };
+	int res{ 0 };
+	for (int e = 0; e < mesh.GetNE(); e++) {
+		for (int k = 0; k < adj.RowSize(e); k++) {
+			res = std::max(res, std::abs(adj.GetRow(e)[k] - e));
+		}
+	}
+	return res;
+}
+
+Array<int> buildElementOrdering(Mesh& mesh, const ElementOrdering& ordering)
+{
+	switch (ordering) {
+	case ElementOrdering::Hilbert:
+		// Curves in 1D reduce to sorting along the line.
+		if (mesh.SpaceDimension() == 1) {
+			return toOrdering(sortByCoordinate(mesh));
+		}
+		else {
+			Array<int> res;
+			mesh.GetHilbertElementOrdering(res);
+			return res;
+		}
+	case ElementOrdering::Morton:
+		return toOrdering(sortByMortonCode(mesh));
+	case ElementOrdering::ReverseCuthillMcKee:
+		return toOrdering(sortByReverseCuthillMcKee(mesh));
+	default:
+		Array<int> res(mesh.GetNE());
+		for (int e = 0; e < res.Size(); e++) {
+			res[e] = e;
+		}
+		return res;
+	}
+}
+
+ElementOrderingReport reorderElements(Mesh& mesh, const ElementOrdering& ordering)
+{
+	ElementOrderingReport res;
+	res.bandwidthBefore = getElementBandwidth(mesh);
+	if (ordering != ElementOrdering::None) {
+		mesh.ReorderElements(buildElementOrdering(mesh, ordering));
+	}
+	res.bandwidthAfter = getElementBandwidth(mesh);
+	return res;
+}
+
+}
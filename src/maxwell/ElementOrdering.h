@@ -0,0 +1,29 @@
+#pragma once
+
+#include <mfem.hpp>
+
+#include "Types.h"
+
+namespace maxwell {
+
+/** Renumbering of mesh elements for locality of the evolution operators.
+	DG DoFs are numbered element by element, so the bandwidth of the flux
+	operators is set by the largest index distance between elements sharing
+	a face. Space filling curves (Hilbert, Morton) keep nearby elements close
+	in memory, reverse Cuthill-McKee minimizes that distance directly on the
+	face neighbour graph.
+	*/
+struct ElementOrderingReport {
+	// Largest index distance between face neighbours, before and after.
+	int bandwidthBefore{ 0 };
+	int bandwidthAfter{ 0 };
+};
+
+int getElementBandwidth(mfem::Mesh&);
+
+// ordering[e] is the new index of element e.
+mfem::Array<int> buildElementOrdering(mfem::Mesh&, const ElementOrdering&);
+
+ElementOrderingReport reorderElements(mfem::Mesh&, const ElementOrdering&);
+
+}
@@ -1,33 +1,122 @@
 #include "Fields.h"
 #include "MaxwellEvolution1D.h"
 #include "MaxwellEvolution3D.h"
+#include "MemoryPlacement.h"
 
 namespace maxwell {
 
 using namespace mfem;
 
-Fields::Fields(mfem::FiniteElementSpace& fes)
+static int getNumberOfComponents(const mfem::FiniteElementSpace& fes)
+{
+    if (fes.GetMesh()->Dimension() == 1) {
+        return MaxwellEvolution1D::numberOfFieldComponents * MaxwellEvolution1D::numberOfMaxDimensions;
+    }
+    return MaxwellEvolution3D::numberOfFieldComponents * MaxwellEvolution3D::numberOfMaxDimensions;
+}
+
+Fields::Fields(mfem::FiniteElementSpace& fes, const FieldsLayout& layout, const MemoryPlacementOptions& placement) :
+    fieldDOFs_{ getNumberOfComponents(fes) * fes.GetNDofs() },
+    layout_{ fes, getNumberOfComponents(fes), layout },
+    placement_{ placement }
 {
     switch (fes.GetMesh()->Dimension()) {
     case 1:
-        allDOFs.SetSize(MaxwellEvolution1D::numberOfFieldComponents * MaxwellEvolution1D::numberOfMaxDimensions * fes.GetNDofs());
-        allDOFs = 0.0;
         E1D.SetSpace(&fes);
         H1D.SetSpace(&fes);
-        E1D.SetData(allDOFs.GetData());
-        H1D.SetData(allDOFs.GetData() + fes.GetNDofs());
         break;
     default:
-        allDOFs.SetSize(MaxwellEvolution3D::numberOfFieldComponents * MaxwellEvolution3D::numberOfMaxDimensions * fes.GetNDofs());
-        allDOFs = 0.0;
         for (int d = X; d <= Z; d++) {
             E[d].SetSpace(&fes);
             H[d].SetSpace(&fes);
-            E[d].SetData(allDOFs.GetData() + d * fes.GetNDofs());
-            H[d].SetData(allDOFs.GetData() + (d + 3) * fes.GetNDofs());
         }
         break;
     }
+    allocate(allDOFs, fieldDOFs_);
+    bindFields();
+    updateViews();
+}
+
+void Fields::allocate(Vector& v, int size) const
+{
+    if (placement_.firstTouch) {
+        allocateByFirstTouch(v, size, layout_, placement_.hugePages);
+        return;
+    }
+    v.SetSize(size);
+    v = 0.0;
+}
+
+void Fields::bindFields()
+{
+    if (!layout_.isBlocked()) {
+        return;
+    }
+    if (E1D.FESpace() != nullptr) {
+        const auto ndofs{ E1D.FESpace()->GetNDofs() };
+        E1D.SetData(allDOFs.GetData());
+        H1D.SetData(allDOFs.GetData() + ndofs);
+        return;
+    }
+    const auto ndofs{ E[X].FESpace()->GetNDofs() };
+    for (int d = X; d <= Z; d++) {
+        E[d].SetData(allDOFs.GetData() + d * ndofs);
+        H[d].SetData(allDOFs.GetData() + (d + 3) * ndofs);
+    }
+}
+
+void Fields::setNumberOfAuxiliaryDOFs(int n)
+{
+    Vector resized;
+    allocate(resized, fieldDOFs_ + n);
+    for (int i = 0; i < fieldDOFs_; i++) {
+        resized[i] = allDOFs[i];
+    }
+    allDOFs.Swap(resized);
+    bindFields();
+}
+
+void Fields::updateViews()
+{
+    if (layout_.isBlocked()) {
+        return;
+    }
+    for (int c = 0; c < layout_.getNumberOfComponents(); c++) {
+        auto& view{ getView(c) };
+        layout_.gather(allDOFs, c, view);
+    }
+}
+
+void Fields::updateDOFs()
+{
+    if (layout_.isBlocked()) {
+        return;
+    }
+    for (int c = 0; c < layout_.getNumberOfComponents(); c++) {
+        const auto& view{ getView(c) };
+        layout_.scatter(view, c, allDOFs);
+    }
+}
+
+mfem::GridFunction& Fields::getView(int c)
+{
+    if (E1D.FESpace() != nullptr) {
+        return get(FieldType(c), X);
+    }
+    return get(FieldType(c / 3), c % 3);
+}
+
+mfem::GridFunction& Fields::get(const FieldType& f, const Direction& d)
+{
+    const auto is1D{ E1D.FESpace() != nullptr };
+    switch (f) {
+    case FieldType::E:
+        return is1D ? E1D : E[d];
+    case FieldType::H:
+        return is1D ? H1D : H[d];
+    default:
+        throw std::runtime_error("Invalid field type.");
+    }
 }
 
 }
\ No newline at end of file
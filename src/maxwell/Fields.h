@@ -4,12 +4,13 @@
 
 #include "Types.h"
 #include "Sources.h"
+#include "StateLayout.h"
 
 namespace maxwell {
 
 class Fields {
 public:
-    Fields(mfem::FiniteElementSpace& fes);
+    Fields(mfem::FiniteElementSpace& fes, const FieldsLayout& layout = FieldsLayout::Blocked, const MemoryPlacementOptions& placement = {});
     
     std::array<mfem::GridFunction, 3> E, H;
     mfem::GridFunction E1D, H1D;
@@ -17,5 +18,30 @@ public:
 
     double getNorml2() const { return allDOFs.Norml2(); }
 
+    mfem::GridFunction& get(const FieldType&, const Direction&);
+
+    // Auxiliary unknowns, e.g. of absorbing layers, are appended to allDOFs
+    // after the field components, which keep their values.
+    void setNumberOfAuxiliaryDOFs(int);
+    int getNumberOfFieldDOFs() const { return fieldDOFs_; }
+
+    const StateLayout& getLayout() const { return layout_; }
+    // The views alias allDOFs in blocked layouts. Otherwise they hold copies
+    // of the components: updateViews gathers them from allDOFs, e.g. before
+    // probes read them, and updateDOFs scatters back changes made through them.
+    void updateViews();
+    void updateDOFs();
+
+private:
+    int fieldDOFs_;
+    StateLayout layout_;
+    MemoryPlacementOptions placement_;
+
+    void allocate(mfem::Vector&, int size) const;
+
+    void bindFields();
+    // View of a component of the state vector, in the order of StateLayout.
+    mfem::GridFunction& getView(int);
+
 };
 }
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "Hashing.h"
+
+namespace maxwell {
+
+using namespace mfem;
+
+Hasher& Hasher::add(const void* data, std::size_t size)
+{
+	const auto* bytes{ static_cast<const unsigned char*>(data) };
+	for (std::size_t i{ 0 }; i < size; i++) {
+		hash_ ^= bytes[i];
+		hash_ *= 1099511628211ull;
+	}
+	return *this;
+}
+
+Hasher& Hasher::add(const std::string& s)
+{
+	add(s.size());
+	return add(s.data(), s.size());
+}
+
+Hasher& Hasher::add(const Mesh& mesh)
+{
+	add(mesh.Dimension());
+	add(mesh.SpaceDimension());
+	add(mesh.GetNV());
+	add(mesh.GetNE());
+	add(mesh.GetNBE());
+
+	for (int v = 0; v < mesh.GetNV(); v++) {
+		add(mesh.GetVertex(v), mesh.SpaceDimension() * sizeof(double));
+	}
+
+	Array<int> vertices;
+	for (int e = 0; e < mesh.GetNE(); e++) {
+		add(mesh.GetAttribute(e));
+		add(mesh.GetElementBaseGeometry(e));
+		mesh.GetElementVertices(e, vertices);
+		add(vertices.GetData(), vertices.Size() * sizeof(int));
+	}
+	for (int be = 0; be < mesh.GetNBE(); be++) {
+		add(mesh.GetBdrAttribute(be));
+		mesh.GetBdrElementVertices(be, vertices);
+		add(vertices.GetData(), vertices.Size() * sizeof(int));
+	}
+
+	// High order meshes also depend on their nodes.
+	if (const auto* nodes{ mesh.GetNodes() }) {
+		add(nodes->FESpace()->GetMaxElementOrder());
+		add(nodes->GetData(), nodes->Size() * sizeof(double));
+	}
+	return *this;
+}
+
+Hasher& Hasher::add(const Model& model)
+{
+	add(model.getMesh());
+	for (const auto& kv : model.getAttributeToMaterial()) {
+		add(kv.first);
+		add(kv.second.getPermittivity());
+		add(kv.second.getPermeability());
+		add(kv.second.getConductivity());
+		for (const auto& p : kv.second.getDebyePoles()) {
+			add(p);
+		}
+		for (const auto& p : kv.second.getDrudePoles()) {
+			add(p);
+		}
+		for (const auto& p : kv.second.getLorentzPoles()) {
+			add(p);
+		}
+	}
+	for (const auto& kv : model.getAttributeToBoundary()) {
+		add(kv.first);
+		add(kv.second);
+	}
+	for (const auto& kv : model.getAttributeToPML()) {
+		add(kv.first);
+		add(kv.second.maxConductivity);
+		add(kv.second.profileOrder);
+	}
+	return *this;
+}
+
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <mfem.hpp>
+
+#include "Model.h"
+
+namespace maxwell {
+
+/** Incremental 64 bit FNV-1a hash.
+	Used to tag files written for a given configuration, so they are not
+	read back by a run with a different one.
+	*/
+class Hasher {
+public:
+	Hasher& add(const void* data, std::size_t size);
+	
+	template <class T>
+	Hasher& add(const T& v) 
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be hashed.");
+		return add(&v, sizeof(T));
+	}
+
+	Hasher& add(const std::string&);
+	Hasher& add(const mfem::Mesh&);
+	Hasher& add(const Model&);
+
+	std::uint64_t value() const { return hash_; }
+
+private:
+	std::uint64_t hash_{ 14695981039346656037ull };
+};
+
+}
@@ -0,0 +1,163 @@
+#include "MappedFile.h"
+
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace maxwell {
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& filename, Access access) :
+	filename_{ filename },
+	access_{ access }
+{
+	file_ = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file_ == INVALID_HANDLE_VALUE) {
+		file_ = nullptr;
+		throw std::runtime_error("Could not open file " + filename);
+	}
+	LARGE_INTEGER size;
+	GetFileSizeEx(file_, &size);
+	size_ = static_cast<std::size_t>(size.QuadPart);
+	if (size_ == 0) {
+		return;
+	}
+	const auto copyOnWrite{ access_ == Access::CopyOnWrite };
+	mapping_ = CreateFileMappingA(file_, nullptr, copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+	if (mapping_ != nullptr) {
+		data_ = static_cast<char*>(MapViewOfFile(mapping_, copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0));
+	}
+	if (data_ == nullptr) {
+		release();
+		throw std::runtime_error("Could not map file " + filename);
+	}
+}
+
+void MappedFile::release()
+{
+	if (data_ != nullptr) {
+		UnmapViewOfFile(data_);
+	}
+	if (mapping_ != nullptr) {
+		CloseHandle(mapping_);
+	}
+	if (file_ != nullptr) {
+		CloseHandle(file_);
+	}
+	data_ = nullptr;
+	mapping_ = nullptr;
+	file_ = nullptr;
+	size_ = 0;
+}
+
+void truncateFile(const std::string& filename, std::size_t size)
+{
+	int fd{ -1 };
+	if (_sopen_s(&fd, filename.c_str(), _O_RDWR | _O_BINARY, _SH_DENYNO, _S_IREAD | _S_IWRITE) != 0) {
+		throw std::runtime_error("Could not open file " + filename);
+	}
+	const auto res{ _chsize_s(fd, static_cast<__int64>(size)) };
+	_close(fd);
+	if (res != 0) {
+		throw std::runtime_error("Could not resize file " + filename);
+	}
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& filename, Access access) :
+	filename_{ filename },
+	access_{ access }
+{
+	const auto fd{ open(filename.c_str(), O_RDONLY) };
+	if (fd < 0) {
+		throw std::runtime_error("Could not open file " + filename);
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		close(fd);
+		throw std::runtime_error("Could not stat file " + filename);
+	}
+	size_ = static_cast<std::size_t>(st.st_size);
+	if (size_ > 0) {
+		// Private mappings still share the pages which are never written.
+		auto* addr{ access_ == Access::CopyOnWrite ?
+			mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0) :
+			mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0) };
+		if (addr == MAP_FAILED) {
+			close(fd);
+			throw std::runtime_error("Could not map file " + filename);
+		}
+		data_ = static_cast<char*>(addr);
+	}
+	// The mapping keeps its own reference to the file.
+	close(fd);
+}
+
+void MappedFile::release()
+{
+	if (data_ != nullptr) {
+		munmap(data_, size_);
+	}
+	data_ = nullptr;
+	size_ = 0;
+}
+
+void truncateFile(const std::string& filename, std::size_t size)
+{
+	if (truncate(filename.c_str(), static_cast<off_t>(size)) != 0) {
+		throw std::runtime_error("Could not resize file " + filename);
+	}
+}
+
+#endif
+
+MappedFile::~MappedFile()
+{
+	release();
+}
+
+char* MappedFile::getWritableData()
+{
+	if (access_ != Access::CopyOnWrite) {
+		throw std::runtime_error(filename_ + " is mapped read-only.");
+	}
+	return data_;
+}
+
+MappedFile::MappedFile(MappedFile&& rhs) noexcept
+{
+	*this = std::move(rhs);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& rhs) noexcept
+{
+	if (this != &rhs) {
+		release();
+		filename_ = std::move(rhs.filename_);
+		access_ = rhs.access_;
+		std::swap(data_, rhs.data_);
+		std::swap(size_, rhs.size_);
+#ifdef _WIN32
+		std::swap(file_, rhs.file_);
+		std::swap(mapping_, rhs.mapping_);
+#endif
+	}
+	return *this;
+}
+
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+
+namespace maxwell {
+
+/** Memory mapping of a whole file.
+	Pages are loaded on demand and shared with any other process mapping the
+	same file. Copy on write mappings can also be written through
+	getWritableData: written pages become private copies and the file is
+	never modified. The mapping is released on destruction.
+	*/
+class MappedFile {
+public:
+	enum class Access {
+		ReadOnly,
+		CopyOnWrite
+	};
+
+	MappedFile(const std::string& filename, Access = Access::ReadOnly);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile(MappedFile&&) noexcept;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile& operator=(MappedFile&&) noexcept;
+
+	const char* data() const { return data_; }
+	// Throws for read-only mappings.
+	char* getWritableData();
+	std::size_t size() const { return size_; }
+	const std::string& getFilename() const { return filename_; }
+
+private:
+	std::string filename_;
+	Access access_{ Access::ReadOnly };
+	char* data_{ nullptr };
+	std::size_t size_{ 0 };
+#ifdef _WIN32
+	void* file_{ nullptr };
+	void* mapping_{ nullptr };
+#endif
+
+	void release();
+};
+
+// Shrinks or extends a file to the given size.
+void truncateFile(const std::string& filename, std::size_t size);
+
+}
@@ -4,9 +4,10 @@
 
 namespace maxwell {
 
-Material::Material(double epsilon, double mu) :
+Material::Material(double epsilon, double mu, double conductivity) :
 	epsilon_(epsilon),
-	mu_(mu)
+	mu_(mu),
+	sigma_(conductivity)
 {
 	if (epsilon_ < 1.0) {
 		throw std::runtime_error("Permittivity under 1.0 not allowed.");
@@ -14,6 +15,36 @@ Material::Material(double epsilon, double mu) :
 	if (mu_ < 1.0) {
 		throw std::runtime_error("Permeability under 1.0 not allowed.");
 	}
+	if (sigma_ < 0.0) {
+		throw std::runtime_error("Negative conductivity not allowed.");
+	}
+}
+
+Material& Material::addDebyePole(const DebyePole& p)
+{
+	if (p.deltaEpsilon <= 0.0 || p.relaxationTime <= 0.0) {
+		throw std::runtime_error("Debye poles need positive permittivity increment and relaxation time.");
+	}
+	debyePoles_.push_back(p);
+	return *this;
+}
+
+Material& Material::addDrudePole(const DrudePole& p)
+{
+	if (p.plasmaFrequency <= 0.0 || p.collisionFrequency < 0.0) {
+		throw std::runtime_error("Drude poles need positive plasma frequency and non negative collision frequency.");
+	}
+	drudePoles_.push_back(p);
+	return *this;
 }
 
-}
\ No newline at end of file
+Material& Material::addLorentzPole(const LorentzPole& p)
+{
+	if (p.deltaEpsilon <= 0.0 || p.resonanceFrequency <= 0.0 || p.damping < 0.0) {
+		throw std::runtime_error("Lorentz poles need positive permittivity increment and resonance frequency, and non negative damping.");
+	}
+	lorentzPoles_.push_back(p);
+	return *this;
+}
+
+}
@@ -1,20 +1,55 @@
 #pragma once
 
 #include <math.h>
+#include <vector>
 
 namespace maxwell {
 
+// Relative permittivity eps(w) = deltaEpsilon / (1 + j w relaxationTime).
+struct DebyePole {
+	double deltaEpsilon;
+	double relaxationTime;
+};
+
+// Relative permittivity eps(w) = - plasmaFrequency^2 / (w^2 - j w collisionFrequency).
+struct DrudePole {
+	double plasmaFrequency;
+	double collisionFrequency;
+};
+
+// Relative permittivity eps(w) = deltaEpsilon w0^2 / (w0^2 - w^2 + j w damping).
+struct LorentzPole {
+	double deltaEpsilon;
+	double resonanceFrequency;
+	double damping;
+};
+
 class Material {
 public:
-	Material(double epsilon, double mu);
+	Material(double epsilon, double mu, double conductivity = 0.0);
+
+	// Dispersive materials add their poles to epsilon, which is the high frequency permittivity.
+	Material& addDebyePole(const DebyePole&);
+	Material& addDrudePole(const DrudePole&);
+	Material& addLorentzPole(const LorentzPole&);
 
 	double getPermittivity() const { return epsilon_; }
 	double getPermeability() const { return mu_; }
+	double getConductivity() const { return sigma_; }
 	double getImpedance() const { return sqrt(mu_ / epsilon_); }
 	double getAdmitance() const { return sqrt(epsilon_ / mu_); }
 
+	const std::vector<DebyePole>& getDebyePoles() const { return debyePoles_; }
+	const std::vector<DrudePole>& getDrudePoles() const { return drudePoles_; }
+	const std::vector<LorentzPole>& getLorentzPoles() const { return lorentzPoles_; }
+	bool isDispersive() const { return !debyePoles_.empty() || !drudePoles_.empty() || !lorentzPoles_.empty(); }
+
 private:
-	double epsilon_, mu_;
+	double epsilon_, mu_, sigma_;
+
+	std::vector<DebyePole> debyePoles_;
+	std::vector<DrudePole> drudePoles_;
+	std::vector<LorentzPole> lorentzPoles_;
 };
 
-}
\ No newline at end of file
+}
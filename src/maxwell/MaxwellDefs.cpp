@@ -1,9 +1,23 @@
 #include "MaxwellDefs.h"
+#include "MemoryPlacement.h"
+
+#include <algorithm>
 
 namespace maxwell {
 
 using namespace mfem;
 
+// Parallel spaces get parallel forms, which also assemble the faces shared with other ranks.
+static FiniteElementOperator newBilinearForm(FiniteElementSpace& fes)
+{
+#ifdef MFEM_USE_MPI
+	if (auto* pfes{ dynamic_cast<ParFiniteElementSpace*>(&fes) }) {
+		return std::make_unique<ParBilinearForm>(pfes);
+	}
+#endif
+	return std::make_unique<BilinearForm>(&fes);
+}
+
 FiniteElementOperator buildByMult(
 	const BilinearForm& op1,
 	const BilinearForm& op2,
@@ -18,13 +32,80 @@ FiniteElementOperator buildByMult(
 	return res;
 }
 
+void placeOperators(const std::vector<FiniteElementOperator*>& ops, const MaxwellEvolOptions& opts, bool areMapped)
+{
+	const auto& placement{ opts.memoryPlacement };
+	if (!placement.firstTouch || areMapped) {
+		return;
+	}
+	for (auto* op : ops) {
+		if (*op) {
+			placeByFirstTouch((*op)->SpMat(), placement.hugePages);
+		}
+	}
+}
+
+Vector buildConductiveLosses(const Model& model, const FiniteElementSpace& fes)
+{
+	Vector res;
+	const auto& materials{ model.getAttributeToMaterial() };
+	const auto isLossy{ std::any_of(materials.begin(), materials.end(),
+		[](const auto& kv) { return kv.second.getConductivity() > 0.0; }) };
+	if (!isLossy) {
+		return res;
+	}
+
+	res.SetSize(fes.GetNDofs());
+	res = 0.0;
+	Array<int> dofs;
+	for (int e = 0; e < fes.GetNE(); e++) {
+		const auto it{ materials.find(fes.GetMesh()->GetAttribute(e)) };
+		if (it == materials.end()) {
+			continue;
+		}
+		fes.GetElementDofs(e, dofs);
+		for (const auto& dof : dofs) {
+			res[dof] = it->second.getConductivity() / it->second.getPermittivity();
+		}
+	}
+	return res;
+}
+
+void initializeWithLosses(const Vector& losses, const StateLayout& layout, const std::vector<int>& eComponents, const Vector& in, Vector& out)
+{
+	// DoFs are split among threads as in the kernels, so this first write
+	// also places the pages of new stage vectors, see MemoryPlacement.h.
+	const auto ndofs{ layout.getNDofs() };
+	const auto components{ layout.getNumberOfComponents() };
+	const auto isLossy{ losses.Size() != 0 };
+#pragma omp parallel for schedule(static)
+	for (int j = 0; j < ndofs; j++) {
+		for (int c = 0; c < components; c++) {
+			out[layout.index(c, j)] = 0.0;
+		}
+		if (isLossy) {
+			for (const auto& c : eComponents) {
+				const auto i{ layout.index(c, j) };
+				out[i] = -losses[j] * in[i];
+			}
+		}
+	}
+}
+
+OperatorGroup getFluxGroup(const FieldType& f, const FieldType& fIn, const BilinearForm* op, const std::array<FiniteElementOperator, 2>& MP)
+{
+	if (f != fIn) {
+		return OperatorGroup::MFN;
+	}
+	return op == MP[f].get() ? OperatorGroup::MP : OperatorGroup::MFNN;
+}
 
 FiniteElementOperator buildInverseMassMatrix(const FieldType& f, const Model& model, FiniteElementSpace& fes)
 {
 	Vector aux{ model.buildPiecewiseArgVector(f) };
 	PWConstCoefficient PWCoeff(aux);
 
-	auto MInv = std::make_unique<BilinearForm>(&fes);
+	auto MInv = newBilinearForm(fes);
 	MInv->AddDomainIntegrator(new InverseIntegrator(new MassIntegrator(PWCoeff)));
 		
 	MInv->Assemble();
@@ -36,7 +117,7 @@ FiniteElementOperator buildInverseMassMatrix(const FieldType& f, const Model& mo
 
 FiniteElementOperator buildDerivativeOperator(const Direction& d, FiniteElementSpace& fes)
 {
-	auto res = std::make_unique<BilinearForm>(&fes);
+	auto res = newBilinearForm(fes);
 
 	if (d >= fes.GetMesh()->Dimension()) {
 		res->Assemble();
@@ -56,7 +137,7 @@ FiniteElementOperator buildDerivativeOperator(const Direction& d, FiniteElementS
 
 FiniteElementOperator buildFluxOperator(const FieldType& f, const std::vector<Direction>& dirTerms, Model& model, FiniteElementSpace& fes)
 {
-	auto res = std::make_unique<BilinearForm>(&fes);
+	auto res = newBilinearForm(fes);
 
 	{
 		FluxCoefficient c = interiorFluxCoefficient();
@@ -78,7 +159,7 @@ FiniteElementOperator buildFluxOperator(const FieldType& f, const std::vector<Di
 
 FiniteElementOperator buildPenaltyOperator(const FieldType& f, const std::vector<Direction>& dirTerms, Model& model, FiniteElementSpace& fes, const MaxwellEvolOptions& opts)
 {
-	auto res = std::make_unique<BilinearForm>(&fes);
+	auto res = newBilinearForm(fes);
 
 	{
 		FluxCoefficient c = interiorPenaltyFluxCoefficient(opts);
@@ -99,7 +180,7 @@ FiniteElementOperator buildPenaltyOperator(const FieldType& f, const std::vector
 
 FiniteElementOperator buildFluxOperator(const FieldType& f, const std::vector<Direction>& dirTerms, bool usePenaltyCoefficients, Model& model, FiniteElementSpace& fes, const MaxwellEvolOptions& opts)
 {
-	auto res = std::make_unique<BilinearForm>(&fes);
+	auto res = newBilinearForm(fes);
 
 	{
 		FluxCoefficient c;
@@ -132,7 +213,7 @@ FiniteElementOperator buildFluxOperator(const FieldType& f, const std::vector<Di
 
 FiniteElementOperator buildFluxJumpOperator(const FieldType& f, const std::vector<Direction>& dirTerms, bool usePenaltyCoefficients, Model& model, FiniteElementSpace& fes, const MaxwellEvolOptions& opts)
 {
-	auto res = std::make_unique<BilinearForm>(&fes);
+	auto res = newBilinearForm(fes);
 
 	{
 		FluxCoefficient c;
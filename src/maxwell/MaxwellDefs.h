@@ -1,6 +1,7 @@
 #include "Types.h"
 #include "mfem.hpp"
 #include "Model.h"
+#include "StateLayout.h"
 #include "mfemExtension/BilinearIntegrators.h"
 
 namespace maxwell {
@@ -17,6 +18,16 @@ FiniteElementOperator buildFluxOperator(const FieldType& f, const std::vector<Di
 FiniteElementOperator buildPenaltyOperator(const FieldType& f, const std::vector<Direction>& dirTerms, Model& model, FiniteElementSpace& fes, const MaxwellEvolOptions& opts);
 
 
+// Places the operators by first touch when requested, unless they point to a mapped operator cache file.
+void placeOperators(const std::vector<FiniteElementOperator*>& ops, const MaxwellEvolOptions& opts, bool areMapped);
+
+// Conductivity over permittivity at each DoF, empty if there are no losses.
+Vector buildConductiveLosses(const Model& model, const FiniteElementSpace& fes);
+// Sets the field derivatives to - losses .* E on the given electric components, and to zero elsewhere.
+void initializeWithLosses(const Vector& losses, const StateLayout& layout, const std::vector<int>& eComponents, const Vector& in, Vector& out);
+// Flux operators act on the other field (MFN) or on the same one, as penalties (MP) or normal fluxes (MFNN).
+OperatorGroup getFluxGroup(const FieldType& f, const FieldType& fIn, const BilinearForm* op, const std::array<FiniteElementOperator, 2>& MP);
+
 FluxCoefficient interiorFluxCoefficient();
 FluxCoefficient interiorPenaltyFluxCoefficient(const MaxwellEvolOptions& opts);
 FluxCoefficient boundaryFluxCoefficient(const FieldType& f, const BdrCond& bdrC);
@@ -1,4 +1,5 @@
 #include "MaxwellEvolution1D.h"
+#include "OperatorCache.h"
 
 
 namespace maxwell {
@@ -7,11 +8,61 @@ using namespace mfem;
 using namespace mfemExtension;
 
 MaxwellEvolution1D::MaxwellEvolution1D(
-	FiniteElementSpace& fes, Model& model, MaxwellEvolOptions& options) :
+	FiniteElementSpace& fes, Model& model, MaxwellEvolOptions& options, const Sources& sources) :
 	TimeDependentOperator(numberOfFieldComponents * numberOfMaxDimensions * fes.GetNDofs()),
 	fes_{ fes },
 	model_{ model },
-	opts_{ options }
+	opts_{ options },
+	layout_{ fes, numberOfFieldComponents * numberOfMaxDimensions, options.fieldsLayout }
+{
+	if (!model_.getAttributeToPML().empty()) {
+		throw std::runtime_error("PML regions are only available in 2D and 3D.");
+	}
+
+	operatorStore_ = buildCachedOperators(
+		"MaxwellEvolution1D", getOperators(), fes_, model_, opts_, 
+		[this]() { assembleOperators(); }
+	);
+	placeOperators(getOperators(), opts_, operatorStore_ != nullptr);
+	losses_ = buildConductiveLosses(model_, fes_);
+	terms_ = buildTerms();
+
+	if (DispersiveMedia::isDispersive(model_)) {
+		dispersive_ = std::make_unique<DispersiveMedia>(fes_, model_, std::vector<Direction>{ X }, height, layout_);
+		height = width = height + dispersive_->getNumberOfAuxiliaryDOFs();
+	}
+
+	for (const auto& source : sources) {
+		if (const auto* planewave{ dynamic_cast<const Planewave*>(source.get()) }) {
+			sourceTerms_.push_back(std::make_unique<TotalFieldScatteredField>(
+				fes_, *planewave, TotalFieldScatteredField::Components{ { E, Y }, { H, Z } }, getCouplingTerms(), layout_
+			));
+		}
+		else if (const auto* separable{ dynamic_cast<const SeparableSource*>(source.get()) }) {
+			sourceTerms_.push_back(std::make_unique<SeparableSourceTerm>(
+				fes_, model_, *separable, layout_
+			));
+		}
+	}
+
+	auto dipoles{ std::make_unique<PointDipoles>(fes_, model_, sources, PointSourceType::Soft, layout_) };
+	if (!dipoles->empty()) {
+		sourceTerms_.push_back(std::move(dipoles));
+	}
+}
+
+std::vector<FiniteElementOperator*> MaxwellEvolution1D::getOperators()
+{
+	std::vector<FiniteElementOperator*> res;
+	for (auto f : { E, H }) {
+		res.push_back(&MS_[f]);
+		res.push_back(&MF_[f]);
+		res.push_back(&MP_[f]);
+	}
+	return res;
+}
+
+void MaxwellEvolution1D::assembleOperators()
 {
 	for (auto f : {E, H}) {
 		const auto f2{ altField(f) };
@@ -21,29 +72,43 @@ MaxwellEvolution1D::MaxwellEvolution1D(
 	}
 }
 
-void MaxwellEvolution1D::Mult(const Vector& in, Vector& out) const
+std::vector<TotalFieldScatteredField::Term> MaxwellEvolution1D::getCouplingTerms() const
 {
-	Vector eOld, hOld;
-	GridFunction eNew, hNew;
+	// Components are E = Ey and H = Hz, see Planewave.
+	return {
+		{ E, Y, MF_[E].get(), H, Z,  1.0 },
+		{ E, Y, MP_[E].get(), E, Y, -1.0 },
+		{ H, Z, MF_[H].get(), E, Y,  1.0 },
+		{ H, Z, MP_[H].get(), H, Z, -1.0 }
+	};
+}
 
-	eOld.SetDataAndSize(in.GetData(), fes_.GetNDofs());
-	hOld.SetDataAndSize(in.GetData() + fes_.GetNDofs(), fes_.GetNDofs());
-	eNew.MakeRef(&fes_, &out[0]);
-	hNew.MakeRef(&fes_, &out[fes_.GetNDofs()]);
+StateLayout::Terms MaxwellEvolution1D::buildTerms() const
+{
+	// dtE = - sigma/eps * E - MS * H + MF * [H] - MF * [E] (signs in coeff)
+	// dtH = - MS * E + MF * [E] - MF * [H] (signs in coeff)
+	StateLayout::Terms res{
+		{ &MS_[E]->SpMat(), E, H, -1.0, OperatorGroup::MS },
+		{ &MS_[H]->SpMat(), H, E, -1.0, OperatorGroup::MS }
+	};
+	for (const auto& t : getCouplingTerms()) {
+		res.push_back({ &t.op->SpMat(), t.f, t.fIn, t.coefficient, getFluxGroup(t.f, t.fIn, t.op, MP_) });
+	}
+	return StateLayout::groupByOperator(res);
+}
 
+void MaxwellEvolution1D::Mult(const Vector& in, Vector& out) const
+{
+	initializeWithLosses(losses_, layout_, { E }, in, out);
+	layout_.addMult(terms_, in, out);
 
-	// dtE = - MS * H + MF * [H] - MF * [E] (signs in coeff)
-	// Update E.
-	MF_[E]->Mult   (hOld, eNew);
-	MS_[E]->AddMult(hOld, eNew, -1.0);
-	MP_[E]->AddMult(eOld, eNew, -1.0);
+	if (dispersive_) {
+		dispersive_->addTerms(in, out);
+	}
 
-	// dtH = - MS * E + MF * [E] - MF * [H] (signs in coeff)
-	// Update H.
-	MF_[H]->Mult   (eOld, hNew);
-	MS_[H]->AddMult(eOld, hNew, -1.0);
-	MP_[H]->AddMult(hOld, hNew, -1.0);
+	for (const auto& term : sourceTerms_) {
+		term->addTerms(GetTime(), out);
+	}
 }
 
 }
-
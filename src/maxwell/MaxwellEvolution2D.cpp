@@ -1,4 +1,5 @@
 #include "MaxwellEvolution2D.h"
+#include "OperatorCache.h"
 
 namespace maxwell {
 
@@ -6,11 +7,76 @@ using namespace mfem;
 using namespace mfemExtension;
 
 MaxwellEvolution2D::MaxwellEvolution2D(
-	FiniteElementSpace& fes, Model& model, MaxwellEvolOptions& options) :
+	FiniteElementSpace& fes, Model& model, MaxwellEvolOptions& options, const Sources& sources) :
 	TimeDependentOperator(numberOfFieldComponents * numberOfMaxDimensions * fes.GetNDofs()),
 	fes_{ fes },
 	model_{ model },
-	opts_{ options }
+	opts_{ options },
+	layout_{ fes, numberOfFieldComponents * numberOfMaxDimensions, options.fieldsLayout }
+{
+	operatorStore_ = buildCachedOperators(
+		"MaxwellEvolution2D", getOperators(), fes_, model_, opts_, 
+		[this]() { assembleOperators(); }
+	);
+	placeOperators(getOperators(), opts_, operatorStore_ != nullptr);
+	losses_ = buildConductiveLosses(model_, fes_);
+	terms_ = buildTerms();
+
+	if (!model_.getAttributeToPML().empty()) {
+		// Centered curl terms, as in Mult.
+		const std::vector<PerfectlyMatchedLayer::Term> terms{
+			{ H, X, Y, E, Z, -1.0 },
+			{ H, Y, X, E, Z,  1.0 },
+			{ E, Z, X, H, Y,  1.0 },
+			{ E, Z, Y, H, X, -1.0 }
+		};
+		pml_ = std::make_unique<PerfectlyMatchedLayer>(fes_, model_, terms, MS_, MFN_, layout_);
+		height = width = numberOfFieldComponents * numberOfMaxDimensions * fes_.GetNDofs() + pml_->getNumberOfAuxiliaryDOFs();
+	}
+
+	if (DispersiveMedia::isDispersive(model_)) {
+		dispersive_ = std::make_unique<DispersiveMedia>(fes_, model_, std::vector<Direction>{ Z }, height, layout_);
+		height = width = height + dispersive_->getNumberOfAuxiliaryDOFs();
+	}
+
+	for (const auto& source : sources) {
+		if (const auto* planewave{ dynamic_cast<const Planewave*>(source.get()) }) {
+			sourceTerms_.push_back(std::make_unique<TotalFieldScatteredField>(
+				fes_, *planewave, TotalFieldScatteredField::Components{ { E, X }, { E, Y }, { E, Z }, { H, X }, { H, Y }, { H, Z } }, getCouplingTerms(), layout_
+			));
+		}
+		else if (const auto* separable{ dynamic_cast<const SeparableSource*>(source.get()) }) {
+			sourceTerms_.push_back(std::make_unique<SeparableSourceTerm>(
+				fes_, model_, *separable, layout_
+			));
+		}
+	}
+
+	auto dipoles{ std::make_unique<PointDipoles>(fes_, model_, sources, PointSourceType::Soft, layout_) };
+	if (!dipoles->empty()) {
+		sourceTerms_.push_back(std::move(dipoles));
+	}
+}
+
+std::vector<FiniteElementOperator*> MaxwellEvolution2D::getOperators()
+{
+	std::vector<FiniteElementOperator*> res;
+	for (auto f : { E, H }) {
+		res.push_back(&MP_[f]);
+		for (auto d : { X, Y, Z }) {
+			res.push_back(&MS_[f][d]);
+			for (auto f2 : { E, H }) {
+				res.push_back(&MFN_[f][f2][d]);
+				for (auto d2 : { X, Y, Z }) {
+					res.push_back(&MFNN_[f][f2][d][d2]);
+				}
+			}
+		}
+	}
+	return res;
+}
+
+void MaxwellEvolution2D::assembleOperators()
 {
 	for (auto f : { E, H }) {
 		MP_[f] = buildByMult(*buildInverseMassMatrix(f, model_, fes_), *buildPenaltyOperator(f, {}, model_, fes_, opts_), fes_);
@@ -26,55 +92,59 @@ MaxwellEvolution2D::MaxwellEvolution2D(
 	}
 }
 
-void MaxwellEvolution2D::Mult(const Vector& in, Vector& out) const
+std::vector<TotalFieldScatteredField::Term> MaxwellEvolution2D::getCouplingTerms() const
 {
-	std::array<Vector, 3> eOld, hOld;
-	std::array<GridFunction, 3> eNew, hNew;
-	for (int d = X; d <= Z; d++) {
-		eOld[d].SetDataAndSize(in.GetData() + d * fes_.GetNDofs(), fes_.GetNDofs());
-		hOld[d].SetDataAndSize(in.GetData() + (d + 3) * fes_.GetNDofs(), fes_.GetNDofs());
-		eNew[d].MakeRef(&fes_, &out[d * fes_.GetNDofs()]);
-		hNew[d].MakeRef(&fes_, &out[(d + 3) * fes_.GetNDofs()]);
-		eNew[d] = 0.0;
-		hNew[d] = 0.0;
+	std::vector<TotalFieldScatteredField::Term> res{
+		{ H, X, MFN_[H][E][Y].get(), E, Z,  1.0 },
+		{ H, Y, MFN_[H][E][X].get(), E, Z, -1.0 },
+		{ E, Z, MFN_[E][H][Y].get(), H, X,  1.0 },
+		{ E, Z, MFN_[E][H][X].get(), H, Y, -1.0 }
+	};
+	if (opts_.fluxType == FluxType::Upwind) {
+		for (auto x : { X, Y }) {
+			res.push_back({ H, x, MFNN_[H][H][X][x].get(), H, X,  1.0 });
+			res.push_back({ H, x, MFNN_[H][H][Y][x].get(), H, Y,  1.0 });
+			res.push_back({ H, x, MP_[H].get(),            H, x, -1.0 });
+		}
+		res.push_back({ E, Z, MP_[E].get(), E, Z, -1.0 });
 	}
+	return res;
+}
 
-	// Flux term for Hx. LIFT*(Fscale.*FluxHx) = LIFT*(Fscale.*(ny.*dEz + alpha*(nx.*dHx.*nx+ny.*dHy.*nx-dHx)))/2.0;
-
-	MFN_[H][E][Y]    ->AddMult(eOld[Z], hNew[X]);
-
-	//Mass term for Hx. (-Dy*Ez)
-	MS_[H][Y]        ->AddMult(eOld[Z], hNew[X], -1.0);
-
-	// Flux term for Hy. LIFT*(Fscale.*FluxHy) = LIFT*(Fscale.*(-nx.*dEz + alpha*(nx.*dHx.*ny+ny.*dHy.*ny-dHy)))/2.0;
-
-	MFN_[H][E][X]    ->AddMult(eOld[Z], hNew[Y], -1.0);				 
-
-	// Mass term for Hy. (Dx*Ez)
-	MS_[H][X]        ->AddMult(eOld[Z], hNew[Y]);
-
-	// Flux term for Ez. LIFT*(Fscale.*FluxEz) = LIFT*(Fscale.*(-nx.*dHy + ny.*dHx - alpha*dEz))/2.0;
-
-	MFN_[E][H][Y]->AddMult(hOld[X], eNew[Z]);
-	MFN_[E][H][X]->AddMult(hOld[Y], eNew[Z], -1.0);
-
-	// Mass term for Ez. (Dx*Hy - Dy*Hx)
-	MS_[E][X]	 ->AddMult(hOld[Y], eNew[Z]);
-	MS_[E][Y]    ->AddMult(hOld[X], eNew[Z], -1.0);
+StateLayout::Terms MaxwellEvolution2D::buildTerms() const
+{
+	auto component = [](const FieldType& f, const Direction& d) { return getComponent(2, f, d); };
+
+	// Mass terms, Hx = -Dy Ez, Hy = Dx Ez and Ez = Dx Hy - Dy Hx.
+	StateLayout::Terms res{
+		{ &MS_[H][Y]->SpMat(), component(H, X), component(E, Z), -1.0, OperatorGroup::MS },
+		{ &MS_[H][X]->SpMat(), component(H, Y), component(E, Z),  1.0, OperatorGroup::MS },
+		{ &MS_[E][X]->SpMat(), component(E, Z), component(H, Y),  1.0, OperatorGroup::MS },
+		{ &MS_[E][Y]->SpMat(), component(E, Z), component(H, X), -1.0, OperatorGroup::MS }
+	};
+	// Flux terms, e.g. LIFT*(Fscale.*FluxEz) = LIFT*(Fscale.*(-nx.*dHy + ny.*dHx - alpha*dEz))/2.0.
+	for (const auto& t : getCouplingTerms()) {
+		res.push_back({ &t.op->SpMat(), component(t.f, t.c), component(t.fIn, t.cIn), t.coefficient, getFluxGroup(t.f, t.fIn, t.op, MP_) });
+	}
+	return StateLayout::groupByOperator(res);
+}
 
-	if (opts_.fluxType == FluxType::Upwind) {
-		MFNN_[H][H][X][X]->AddMult(hOld[X], hNew[X]);
-		MFNN_[H][H][Y][X]->AddMult(hOld[Y], hNew[X]);
-		MP_[H]->AddMult(hOld[X], hNew[X], -1.0);
+void MaxwellEvolution2D::Mult(const Vector& in, Vector& out) const
+{
+	initializeWithLosses(losses_, layout_, { 0, 1, 2 }, in, out);
+	layout_.addMult(terms_, in, out);
 
-		MFNN_[H][H][X][Y]->AddMult(hOld[X], hNew[Y]);
-		MFNN_[H][H][Y][Y]->AddMult(hOld[Y], hNew[Y]);
-		MP_[H]->AddMult(hOld[Y], hNew[Y], -1.0);
+	if (pml_) {
+		pml_->addTerms(in, out);
+	}
 
-		MP_[E]->AddMult(eOld[Z], eNew[Z], -1.0);
+	if (dispersive_) {
+		dispersive_->addTerms(in, out);
 	}
 
+	for (const auto& term : sourceTerms_) {
+		term->addTerms(GetTime(), out);
+	}
 }
 
 }
-
@@ -1,4 +1,5 @@
 #include "MaxwellEvolution3D.h"
+#include "OperatorCache.h"
 
 namespace maxwell {
 
@@ -6,11 +7,79 @@ using namespace mfem;
 using namespace mfemExtension;
 
 MaxwellEvolution3D::MaxwellEvolution3D(
-	FiniteElementSpace& fes, Model& model, MaxwellEvolOptions& options) :
+	FiniteElementSpace& fes, Model& model, MaxwellEvolOptions& options, const Sources& sources) :
 	TimeDependentOperator(numberOfFieldComponents * numberOfMaxDimensions * fes.GetNDofs()),
 	fes_{ fes },
 	model_{ model },
-	opts_{ options }
+	opts_{ options },
+	layout_{ fes, numberOfFieldComponents * numberOfMaxDimensions, options.fieldsLayout }
+{
+	operatorStore_ = buildCachedOperators(
+		"MaxwellEvolution3D", getOperators(), fes_, model_, opts_, 
+		[this]() { assembleOperators(); }
+	);
+	placeOperators(getOperators(), opts_, operatorStore_ != nullptr);
+	losses_ = buildConductiveLosses(model_, fes_);
+	terms_ = buildTerms();
+
+	if (!model_.getAttributeToPML().empty()) {
+		// Centered curl terms, as in Mult.
+		std::vector<PerfectlyMatchedLayer::Term> terms;
+		for (int x = X; x <= Z; x++) {
+			const auto y{ (x + 1) % 3 };
+			const auto z{ (x + 2) % 3 };
+			terms.push_back({ H, x, y, E, z, -1.0 });
+			terms.push_back({ H, x, z, E, y,  1.0 });
+			terms.push_back({ E, x, y, H, z,  1.0 });
+			terms.push_back({ E, x, z, H, y, -1.0 });
+		}
+		pml_ = std::make_unique<PerfectlyMatchedLayer>(fes_, model_, terms, MS_, MFN_, layout_);
+		height = width = numberOfFieldComponents * numberOfMaxDimensions * fes_.GetNDofs() + pml_->getNumberOfAuxiliaryDOFs();
+	}
+
+	if (DispersiveMedia::isDispersive(model_)) {
+		dispersive_ = std::make_unique<DispersiveMedia>(fes_, model_, std::vector<Direction>{ X, Y, Z }, height, layout_);
+		height = width = height + dispersive_->getNumberOfAuxiliaryDOFs();
+	}
+
+	for (const auto& source : sources) {
+		if (const auto* planewave{ dynamic_cast<const Planewave*>(source.get()) }) {
+			sourceTerms_.push_back(std::make_unique<TotalFieldScatteredField>(
+				fes_, *planewave, TotalFieldScatteredField::Components{ { E, X }, { E, Y }, { E, Z }, { H, X }, { H, Y }, { H, Z } }, getCouplingTerms(), layout_
+			));
+		}
+		else if (const auto* separable{ dynamic_cast<const SeparableSource*>(source.get()) }) {
+			sourceTerms_.push_back(std::make_unique<SeparableSourceTerm>(
+				fes_, model_, *separable, layout_
+			));
+		}
+	}
+
+	auto dipoles{ std::make_unique<PointDipoles>(fes_, model_, sources, PointSourceType::Soft, layout_) };
+	if (!dipoles->empty()) {
+		sourceTerms_.push_back(std::move(dipoles));
+	}
+}
+
+std::vector<FiniteElementOperator*> MaxwellEvolution3D::getOperators()
+{
+	std::vector<FiniteElementOperator*> res;
+	for (auto f : { E, H }) {
+		res.push_back(&MP_[f]);
+		for (auto d : { X, Y, Z }) {
+			res.push_back(&MS_[f][d]);
+			for (auto f2 : { E, H }) {
+				res.push_back(&MFN_[f][f2][d]);
+				for (auto d2 : { X, Y, Z }) {
+					res.push_back(&MFNN_[f][f2][d][d2]);
+				}
+			}
+		}
+	}
+	return res;
+}
+
+void MaxwellEvolution3D::assembleOperators()
 {
 	for (auto f : { E, H }) {
 		MP_[f] = buildByMult(*buildInverseMassMatrix(f, model_, fes_), *buildPenaltyOperator(f, {}, model_, fes_, opts_), fes_);
@@ -26,50 +95,63 @@ MaxwellEvolution3D::MaxwellEvolution3D(
 	}
 }
 
-void MaxwellEvolution3D::Mult(const Vector& in, Vector& out) const
+std::vector<TotalFieldScatteredField::Term> MaxwellEvolution3D::getCouplingTerms() const
 {
-	std::array<Vector, 3> eOld, hOld;
-	std::array<GridFunction, 3> eNew, hNew;
-	for (int d = X; d <= Z; d++) {
-		eOld[d].SetDataAndSize(in.GetData() + d * fes_.GetNDofs(), fes_.GetNDofs());
-		hOld[d].SetDataAndSize(in.GetData() + (d + 3) * fes_.GetNDofs(), fes_.GetNDofs());
-		eNew[d].MakeRef(&fes_, &out[d * fes_.GetNDofs()]);
-		hNew[d].MakeRef(&fes_, &out[(d + 3) * fes_.GetNDofs()]);
-		eNew[d] = 0.0;
-		hNew[d] = 0.0;
+	std::vector<TotalFieldScatteredField::Term> res;
+	for (int x = X; x <= Z; x++) {
+		const auto y{ (x + 1) % 3 };
+		const auto z{ (x + 2) % 3 };
+		res.push_back({ H, x, MFN_[H][E][y].get(), E, z,  1.0 });
+		res.push_back({ H, x, MFN_[H][E][z].get(), E, y, -1.0 });
+		res.push_back({ E, x, MFN_[E][H][y].get(), H, z, -1.0 });
+		res.push_back({ E, x, MFN_[E][H][z].get(), H, y,  1.0 });
+		if (opts_.fluxType == FluxType::Upwind) {
+			for (int d = X; d <= Z; d++) {
+				res.push_back({ H, x, MFNN_[H][H][d][x].get(), H, d, 1.0 });
+				res.push_back({ E, x, MFNN_[E][E][d][x].get(), E, d, 1.0 });
+			}
+			res.push_back({ H, x, MP_[H].get(), H, x, -1.0 });
+			res.push_back({ E, x, MP_[E].get(), E, x, -1.0 });
+		}
 	}
+	return res;
+}
+
+StateLayout::Terms MaxwellEvolution3D::buildTerms() const
+{
+	auto component = [](const FieldType& f, const Direction& d) { return getComponent(3, f, d); };
 
+	StateLayout::Terms res;
 	for (int x = X; x <= Z; x++) {
-		int y = (x + 1) % 3;
-		int z = (x + 2) % 3;
-
-		//Centered
-		MS_[H][y]		 ->AddMult(eOld[z], hNew[x], -1.0);
-		MS_[H][z]		 ->AddMult(eOld[y], hNew[x]);
-		MFN_[H][E][y]  	 ->AddMult(eOld[z], hNew[x], 1.0);
-		MFN_[H][E][z]	 ->AddMult(eOld[y], hNew[x], -1.0);
-		
-		MS_[E][y]		 ->AddMult(hOld[z], eNew[x]);
-		MS_[E][z]		 ->AddMult(hOld[y], eNew[x], -1.0);
-		MFN_[E][H][y]  	 ->AddMult(hOld[z], eNew[x], -1.0);
-		MFN_[E][H][z]	 ->AddMult(hOld[y], eNew[x], 1.0);
+		const auto y{ (x + 1) % 3 };
+		const auto z{ (x + 2) % 3 };
+		res.push_back({ &MS_[H][y]->SpMat(), component(H, x), component(E, z), -1.0, OperatorGroup::MS });
+		res.push_back({ &MS_[H][z]->SpMat(), component(H, x), component(E, y),  1.0, OperatorGroup::MS });
+		res.push_back({ &MS_[E][y]->SpMat(), component(E, x), component(H, z),  1.0, OperatorGroup::MS });
+		res.push_back({ &MS_[E][z]->SpMat(), component(E, x), component(H, y), -1.0, OperatorGroup::MS });
+	}
+	for (const auto& t : getCouplingTerms()) {
+		res.push_back({ &t.op->SpMat(), component(t.f, t.c), component(t.fIn, t.cIn), t.coefficient, getFluxGroup(t.f, t.fIn, t.op, MP_) });
+	}
+	return StateLayout::groupByOperator(res);
+}
 
-		if (opts_.fluxType == FluxType::Upwind) {
-			MFNN_[H][H][X][x]->AddMult(hOld[X], hNew[x], 1.0);
-			MFNN_[H][H][Y][x]->AddMult(hOld[Y], hNew[x], 1.0);
-			MFNN_[H][H][Z][x]->AddMult(hOld[Z], hNew[x], 1.0);
-			MP_[H]			 ->AddMult(hOld[x], hNew[x],-1.0);
-			
-			MFNN_[E][E][X][x]->AddMult(eOld[X], eNew[x], 1.0);
-			MFNN_[E][E][Y][x]->AddMult(eOld[Y], eNew[x], 1.0);
-			MFNN_[E][E][Z][x]->AddMult(eOld[Z], eNew[x], 1.0);
-			MP_[E]			 ->AddMult(eOld[x], eNew[x],-1.0);
-		}
+void MaxwellEvolution3D::Mult(const Vector& in, Vector& out) const
+{
+	initializeWithLosses(losses_, layout_, { 0, 1, 2 }, in, out);
+	layout_.addMult(terms_, in, out);
 
+	if (pml_) {
+		pml_->addTerms(in, out);
 	}
 
+	if (dispersive_) {
+		dispersive_->addTerms(in, out);
+	}
 
+	for (const auto& term : sourceTerms_) {
+		term->addTerms(GetTime(), out);
+	}
 }
 
 }
-
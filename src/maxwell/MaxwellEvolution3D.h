@@ -6,6 +6,12 @@
 #include "Model.h"
 #include "Sources.h"
 #include "MaxwellDefs.h"
+#include "MappedFile.h"
+#include "DispersiveMedia.h"
+#include "TotalFieldScatteredField.h"
+#include "SeparableSourceTerm.h"
+#include "PointDipoles.h"
+#include "PerfectlyMatchedLayer.h"
 
 namespace maxwell {
 
@@ -14,7 +20,7 @@ public:
 	static const int numberOfFieldComponents = 2;
 	static const int numberOfMaxDimensions = 3;
 
-	MaxwellEvolution3D(mfem::FiniteElementSpace&, Model&, MaxwellEvolOptions&);
+	MaxwellEvolution3D(mfem::FiniteElementSpace&, Model&, MaxwellEvolOptions&, const Sources& = Sources());
 	virtual void Mult(const mfem::Vector& x, mfem::Vector& y) const;
 
 private:
@@ -27,6 +33,25 @@ private:
 	mfem::FiniteElementSpace& fes_;
 	Model& model_;
 	MaxwellEvolOptions& opts_;
+	StateLayout layout_;
+
+	// Read-only mapping the operators point to, when they are shared.
+	std::unique_ptr<MappedFile> operatorStore_;
+	std::unique_ptr<DispersiveMedia> dispersive_;
+	// Conductivity over permittivity per DoF, empty when lossless.
+	mfem::Vector losses_;
+	std::unique_ptr<PerfectlyMatchedLayer> pml_;
+
+	SourceTerms sourceTerms_;
+	// Operator terms of Mult, grouped by operator.
+	StateLayout::Terms terms_;
+
+	// All operators, in the order they are cached.
+	std::vector<FiniteElementOperator*> getOperators();
+	void assembleOperators();
+	// Terms of Mult coupling neighbouring elements.
+	std::vector<TotalFieldScatteredField::Term> getCouplingTerms() const;
+	StateLayout::Terms buildTerms() const;
 	
 
 };
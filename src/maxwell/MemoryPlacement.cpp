@@ -0,0 +1,125 @@
+#include "MemoryPlacement.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace maxwell {
+
+using namespace mfem;
+
+// Size of transparent huge pages on x86-64 and most aarch64 kernels.
+static const std::size_t hugePageSize{ 2 << 20 };
+
+void adviseHugePages(void* data, std::size_t bytes)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+	const auto address{ reinterpret_cast<std::uintptr_t>(data) };
+	const auto begin{ (address + hugePageSize - 1) / hugePageSize * hugePageSize };
+	const auto end{ (address + bytes) / hugePageSize * hugePageSize };
+	if (end > begin) {
+		madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE);
+	}
+#endif
+}
+
+void allocateByFirstTouch(Vector& v, int size, const StateLayout& layout, bool hugePages)
+{
+	if (size < layout.getSize()) {
+		throw std::runtime_error("State vectors must hold all the field components.");
+	}
+	Vector res(size);
+	if (hugePages) {
+		adviseHugePages(res.GetData(), size * sizeof(double));
+	}
+
+	auto* data{ res.GetData() };
+	const auto ndofs{ layout.getNDofs() };
+	const auto components{ layout.getNumberOfComponents() };
+#pragma omp parallel for schedule(static)
+	for (int j = 0; j < ndofs; j++) {
+		for (int c = 0; c < components; c++) {
+			data[layout.index(c, j)] = 0.0;
+		}
+	}
+#pragma omp parallel for schedule(static)
+	for (int i = layout.getSize(); i < size; i++) {
+		data[i] = 0.0;
+	}
+	v.Swap(res);
+}
+
+void placeByFirstTouch(SparseMatrix& A, bool hugePages)
+{
+	if (!A.Finalized()) {
+		throw std::runtime_error("Only finalized matrices can be placed.");
+	}
+	const auto height{ A.Height() };
+	const auto* oldI{ A.GetI() };
+	const auto* oldJ{ A.GetJ() };
+	const auto* oldData{ A.GetData() };
+	const auto nnz{ oldI[height] };
+
+	auto* I{ new int[height + 1] };
+	auto* J{ new int[nnz] };
+	auto* data{ new double[nnz] };
+	if (hugePages) {
+		adviseHugePages(J, nnz * sizeof(int));
+		adviseHugePages(data, nnz * sizeof(double));
+	}
+
+	I[0] = oldI[0];
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < height; i++) {
+		I[i + 1] = oldI[i + 1];
+		for (int k = oldI[i]; k < oldI[i + 1]; k++) {
+			J[k] = oldJ[k];
+			data[k] = oldData[k];
+		}
+	}
+
+	SparseMatrix placed(I, J, data, height, A.Width(), true, true, A.ColumnsAreSorted());
+	A.Swap(placed);
+}
+
+PagePlacementReport getPagePlacement(const void* data, std::size_t bytes)
+{
+	PagePlacementReport res;
+	if (data == nullptr || bytes == 0) {
+		return res;
+	}
+#ifdef __linux__
+	const auto pageSize{ (std::uintptr_t) sysconf(_SC_PAGESIZE) };
+	const auto first{ reinterpret_cast<std::uintptr_t>(data) / pageSize };
+	const auto last{ (reinterpret_cast<std::uintptr_t>(data) + bytes - 1) / pageSize };
+	res.pages = last - first + 1;
+
+	std::vector<void*> pages(res.pages);
+	std::vector<int> status(res.pages, -1);
+	for (std::size_t p{ 0 }; p < res.pages; p++) {
+		pages[p] = reinterpret_cast<void*>((first + p) * pageSize);
+	}
+	// Without target nodes move_pages only reports where each page is.
+	if (syscall(SYS_move_pages, 0, (unsigned long) res.pages, pages.data(), nullptr, status.data(), 0) != 0) {
+		return res;
+	}
+	for (const auto& node : status) {
+		if (node >= 0) {
+			res.pagesPerNode[node]++;
+		}
+	}
+#else
+	const std::size_t pageSize{ 4096 };
+	const auto address{ reinterpret_cast<std::uintptr_t>(data) };
+	res.pages = (address + bytes - 1) / pageSize - address / pageSize + 1;
+#endif
+	return res;
+}
+
+}
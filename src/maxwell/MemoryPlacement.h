@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <mfem.hpp>
+
+#include "StateLayout.h"
+
+namespace maxwell {
+
+/** NUMA aware placement of the large arrays of the solver.
+	Operating systems back the pages of a new allocation on the NUMA node of
+	the thread that first writes them. Arrays are therefore allocated without
+	being touched and initialized in parallel with the same static partition
+	of the DoFs the kernels use, so each thread later reads and writes pages
+	of its own socket. Without OpenMP the initialization is sequential and
+	only the huge pages advice has an effect.
+	*/
+
+// Sets v to the given size, filled with zeros by first touch. Values after
+// the field components of the layout are auxiliary and split evenly.
+void allocateByFirstTouch(mfem::Vector& v, int size, const StateLayout&, bool hugePages);
+
+// Moves the arrays of a finalized matrix to pages first touched by the
+// threads which process their rows.
+void placeByFirstTouch(mfem::SparseMatrix&, bool hugePages);
+
+// Asks for transparent huge pages on the aligned part of a range, before it is touched.
+void adviseHugePages(void* data, std::size_t bytes);
+
+struct PagePlacementReport {
+	std::size_t pages{ 0 };
+	// Pages per NUMA node. Pages not backed yet, or all pages when the
+	// placement can not be queried, are missing.
+	std::map<int, std::size_t> pagesPerNode;
+};
+
+// Current NUMA node of the pages of a range, only queried on Linux.
+PagePlacementReport getPagePlacement(const void* data, std::size_t bytes);
+
+}
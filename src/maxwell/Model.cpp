@@ -1,9 +1,32 @@
 #include "Model.h"
 
+#include <set>
+#include <string>
+
 namespace maxwell {
 
-Model::Model(Mesh& mesh, const AttributeToMaterial& matMap, const AttributeToBoundary& bdrMap) :
-	mesh_(mesh)
+Model::Model(Mesh& mesh, const AttributeToMaterial& matMap, const AttributeToBoundary& bdrMap, const AttributeToPML& pmlMap) :
+	Model(std::make_unique<Mesh>(mesh), nullptr, matMap, bdrMap, pmlMap)
+{}
+
+Model::Model(const Model& rhs) :
+	ownedMesh_(rhs.ownedMesh_ ? std::make_unique<Mesh>(*rhs.ownedMesh_) : nullptr),
+	mesh_(ownedMesh_ ? ownedMesh_.get() : rhs.mesh_),
+	attToMatMap_(rhs.attToMatMap_),
+	attToBdrMap_(rhs.attToBdrMap_),
+	attToPMLMap_(rhs.attToPMLMap_),
+	bdrToMarkerMap_(rhs.bdrToMarkerMap_)
+{}
+
+Model Model::buildView(Mesh& mesh, const AttributeToMaterial& matMap, const AttributeToBoundary& bdrMap, const AttributeToPML& pmlMap)
+{
+	return Model(nullptr, &mesh, matMap, bdrMap, pmlMap);
+}
+
+Model::Model(std::unique_ptr<Mesh> ownedMesh, Mesh* mesh, const AttributeToMaterial& matMap, const AttributeToBoundary& bdrMap, const AttributeToPML& pmlMap) :
+	ownedMesh_(std::move(ownedMesh)),
+	mesh_(ownedMesh_ ? ownedMesh_.get() : mesh),
+	attToPMLMap_(pmlMap)
 {
 	if (matMap.size() == 0) {
 		attToMatMap_.emplace(1, Material(1.0, 1.0));
@@ -12,17 +35,44 @@ Model::Model(Mesh& mesh, const AttributeToMaterial& matMap, const AttributeToBou
 		attToMatMap_ = matMap;
 	}
 
+	// Attributes only marking interior faces, e.g. total field/scattered
+	// field surfaces, need no boundary condition.
+	std::set<Attribute> exteriorAttributes;
+	for (int be = 0; be < mesh_->GetNBE(); be++) {
+		int e1, e2;
+		mesh_->GetFaceElements(mesh_->GetBdrElementEdgeIndex(be), &e1, &e2);
+		if (e2 < 0) {
+			exteriorAttributes.insert(mesh_->GetBdrAttribute(be));
+		}
+	}
+
 	if (bdrMap.size() == 0) {
-		for (int i = 1; i <= mesh.bdr_attributes.Size(); i++) {
-			attToBdrMap_.emplace(i, BdrCond::PEC);
+		for (const auto& att : exteriorAttributes) {
+			attToBdrMap_.emplace(att, BdrCond::PEC);
 		}
 	}
 	else {
 		attToBdrMap_ = bdrMap;
 	}
 
-	if (mesh.bdr_attributes.Size() != attToBdrMap_.size()) {
-		throw std::exception("Mesh Boundary Attributes Size and Boundary maps must have same size.");
+	for (const auto& att : exteriorAttributes) {
+		if (attToBdrMap_.find(att) == attToBdrMap_.end()) {
+			throw std::runtime_error("No boundary condition defined for boundary attribute " + std::to_string(att) + ".");
+		}
+	}
+	for (const auto& kv : attToBdrMap_) {
+		if (mesh_->bdr_attributes.Find(kv.first) < 0) {
+			throw std::runtime_error("Boundary attribute " + std::to_string(kv.first) + " is not in the mesh.");
+		}
+	}
+
+	for (const auto& kv : attToPMLMap_) {
+		if (attToMatMap_.find(kv.first) == attToMatMap_.end()) {
+			throw std::runtime_error("PML attributes must have a material.");
+		}
+		if (kv.second.profileOrder < 0) {
+			throw std::runtime_error("PML profile order must be non negative.");
+		}
 	}
 
 	for (const auto& kv : attToBdrMap_) {
@@ -30,7 +80,7 @@ Model::Model(Mesh& mesh, const AttributeToMaterial& matMap, const AttributeToBou
 		const auto& bdr{ kv.second };
 		assert(att > 0);
 
-		BoundaryMarker bdrMarker{ mesh_.bdr_attributes.Max() };
+		BoundaryMarker bdrMarker{ mesh_->bdr_attributes.Max() };
 		bdrMarker = 0;
 		bdrMarker[att - 1] = 1;
 		
@@ -2,16 +2,24 @@
 
 #include <mfem.hpp>
 #include <map>
+#include <memory>
 
 #include "Material.h"
 #include "Types.h"
 
 namespace maxwell {
 
-using Attribute = int;
 using AttributeToMaterial = std::map<Attribute, Material>;
 using AttributeToBoundary = std::map<Attribute, BdrCond>;
 
+struct PMLRegion {
+	// Non positive values give a theoretical normal reflection of 1e-6.
+	double maxConductivity{ 0.0 };
+	int profileOrder{ 2 };
+};
+
+using AttributeToPML = std::map<Attribute, PMLRegion>;
+
 using BoundaryMarker = mfem::Array<int>;
 using BoundaryToMarker = std::multimap<BdrCond, BoundaryMarker>;
 
@@ -19,24 +27,45 @@ class Model {
 public:
 	using Mesh = mfem::Mesh;
 
+	// Keeps a copy of the mesh.
 	Model(
 		Mesh&, 
 		const AttributeToMaterial& = AttributeToMaterial{},
-		const AttributeToBoundary& = AttributeToBoundary{}
+		const AttributeToBoundary& = AttributeToBoundary{},
+		const AttributeToPML& = AttributeToPML{}
 	);
+	Model(const Model&);
+	Model(Model&&) = default;
 
-	Mesh& getMesh() { return mesh_; };
+	// Refers to a mesh owned elsewhere, which must outlive the model and its copies.
+	static Model buildView(
+		Mesh&,
+		const AttributeToMaterial& = AttributeToMaterial{},
+		const AttributeToBoundary& = AttributeToBoundary{},
+		const AttributeToPML& = AttributeToPML{}
+	);
+
+	Mesh& getMesh() { return *mesh_; };
+	const Mesh& getMesh() const { return *mesh_; };
 	
 	BoundaryToMarker& getBoundaryToMarker() { return bdrToMarkerMap_; }
+	const AttributeToMaterial& getAttributeToMaterial() const { return attToMatMap_; }
+	const AttributeToBoundary& getAttributeToBoundary() const { return attToBdrMap_; }
+	const AttributeToPML& getAttributeToPML() const { return attToPMLMap_; }
 
 	mfem::Vector buildPiecewiseArgVector(const FieldType& f) const;
 
 private:
-	Mesh mesh_;
+	// Null for views.
+	std::unique_ptr<Mesh> ownedMesh_;
+	Mesh* mesh_;
 	
 	AttributeToMaterial attToMatMap_;
 	AttributeToBoundary attToBdrMap_;
+	AttributeToPML attToPMLMap_;
 	BoundaryToMarker bdrToMarkerMap_;
+
+	Model(std::unique_ptr<Mesh> ownedMesh, Mesh*, const AttributeToMaterial&, const AttributeToBoundary&, const AttributeToPML&);
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,221 @@
+#include "OperatorCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "Checkpoint.h"
+#include "Hashing.h"
+#include "MappedFile.h"
+
+namespace maxwell {
+
+using namespace mfem;
+
+static const char operatorCacheMagic[8]{ 'M', 'X', 'W', 'L', 'O', 'P', 'S', '\0' };
+static const std::uint32_t operatorCacheVersion{ 2 };
+static const std::size_t operatorCacheAlignment{ 64 };
+
+static_assert(sizeof(int) == sizeof(std::int32_t), "Cached operators store 32 bit indices.");
+
+std::uint64_t buildOperatorCacheKey(
+	const std::string& evolutionName, 
+	const FiniteElementSpace& fes, 
+	const Model& model, 
+	const MaxwellEvolOptions& opts)
+{
+	Hasher h;
+	h.add(evolutionName);
+	h.add(operatorCacheVersion);
+	h.add(model);
+	h.add(std::string{ fes.FEColl()->Name() });
+	h.add(fes.GetOrdering());
+	h.add(opts.fluxType);
+	return h.value();
+}
+
+std::string getOperatorCacheFilename(const std::string& directory, std::uint64_t key)
+{
+	std::stringstream ss;
+	ss << directory << "/maxwell_operators_" << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+	return ss.str();
+}
+
+// CSR arrays of a file that passed the header check may still be corrupt.
+static bool isValidCSR(const int* I, const int* J, int height, int width, int nnz)
+{
+	if (I[0] != 0 || I[height] != nnz) {
+		return false;
+	}
+	for (int i = 0; i < height; i++) {
+		if (I[i] > I[i + 1]) {
+			return false;
+		}
+	}
+	return std::all_of(J, J + nnz, [&](int j) { return j >= 0 && j < width; });
+}
+
+FiniteElementOperator buildFromSparseMatrix(SparseMatrix& m, FiniteElementSpace& fes)
+{
+	auto res = std::make_unique<BilinearForm>(&fes);
+	res->Assemble();
+	res->Finalize();
+	res->SpMat().Swap(m);
+	return res;
+}
+
+// Returns false if the file does not hold the expected operators.
+static bool readOperators(
+	MappedFile& file,
+	std::uint64_t key,
+	std::size_t numberOfOperators,
+	FiniteElementSpace& fes,
+	bool inPlace,
+	std::vector<FiniteElementOperator>& loaded)
+{
+	BinaryReader r{ file.data(), file.size() };
+	char magic[sizeof(operatorCacheMagic)];
+	r.read(magic, sizeof(magic));
+	if (std::memcmp(magic, operatorCacheMagic, sizeof(magic)) != 0 ||
+		r.read<std::uint32_t>() != operatorCacheVersion ||
+		r.read<std::uint64_t>() != key ||
+		r.read<std::uint64_t>() != numberOfOperators) {
+		return false;
+	}
+
+	for (std::size_t k{ 0 }; k < numberOfOperators; k++) {
+		const auto height{ r.read<std::int32_t>() };
+		const auto width{ r.read<std::int32_t>() };
+		const auto nnz{ r.read<std::int32_t>() };
+		if (height != fes.GetVSize() || width != fes.GetVSize() || nnz < 0) {
+			return false;
+		}
+		r.align(operatorCacheAlignment);
+		const auto* I{ reinterpret_cast<const int*>(r.view((height + 1) * sizeof(int))) };
+		r.align(operatorCacheAlignment);
+		const auto* J{ reinterpret_cast<const int*>(r.view(nnz * sizeof(int))) };
+		r.align(operatorCacheAlignment);
+		const auto* A{ reinterpret_cast<const double*>(r.view(nnz * sizeof(double))) };
+		if (!isValidCSR(I, J, height, width, nnz)) {
+			return false;
+		}
+
+		if (inPlace) {
+			auto writable = [&](const void* p) { return file.getWritableData() + (static_cast<const char*>(p) - file.data()); };
+			// Not owned, the matrix is only a view of the mapped arrays.
+			SparseMatrix m{
+				reinterpret_cast<int*>(writable(I)),
+				reinterpret_cast<int*>(writable(J)),
+				reinterpret_cast<double*>(writable(A)),
+				height, width, false, false, true
+			};
+			loaded.push_back(buildFromSparseMatrix(m, fes));
+		}
+		else {
+			SparseMatrix m{ new int[height + 1], new int[nnz], new double[nnz], height, width };
+			std::copy(I, I + height + 1, m.GetI());
+			std::copy(J, J + nnz, m.GetJ());
+			std::copy(A, A + nnz, m.GetData());
+			loaded.push_back(buildFromSparseMatrix(m, fes));
+		}
+	}
+	return true;
+}
+
+std::unique_ptr<MappedFile> loadOperators(
+	const std::string& directory, 
+	std::uint64_t key, 
+	const std::vector<FiniteElementOperator*>& ops, 
+	FiniteElementSpace& fes,
+	bool inPlace)
+{
+	const auto filename{ getOperatorCacheFilename(directory, key) };
+	if (!std::ifstream{ filename }.good()) {
+		return nullptr;
+	}
+
+	// In place operators are written through mfem's non const interface,
+	// so their pages are mapped copy on write instead of read-only.
+	std::unique_ptr<MappedFile> file;
+	std::vector<FiniteElementOperator> loaded;
+	bool isValid;
+	try {
+		file = std::make_unique<MappedFile>(filename, inPlace ? MappedFile::Access::CopyOnWrite : MappedFile::Access::ReadOnly);
+		isValid = readOperators(*file, key, ops.size(), fes, inPlace, loaded);
+	}
+	catch (const std::runtime_error&) {
+		// Truncated files fail to be read, they are reassembled as a miss.
+		return nullptr;
+	}
+	if (!isValid) {
+		return nullptr;
+	}
+
+	for (std::size_t k{ 0 }; k < ops.size(); k++) {
+		*ops[k] = std::move(loaded[k]);
+	}
+	return file;
+}
+
+void saveOperators(const std::string& directory, std::uint64_t key, const std::vector<FiniteElementOperator*>& ops)
+{
+	BinaryWriter w;
+	w.write(operatorCacheMagic, sizeof(operatorCacheMagic));
+	w.write(operatorCacheVersion);
+	w.write(key);
+	w.write<std::uint64_t>(ops.size());
+	for (const auto* op : ops) {
+		const auto& m{ (*op)->SpMat() };
+		w.write<std::int32_t>(m.Height());
+		w.write<std::int32_t>(m.Width());
+		w.write<std::int32_t>(m.NumNonZeroElems());
+		w.align(operatorCacheAlignment);
+		w.write(m.GetI(), (m.Height() + 1) * sizeof(int));
+		w.align(operatorCacheAlignment);
+		w.write(m.GetJ(), m.NumNonZeroElems() * sizeof(int));
+		w.align(operatorCacheAlignment);
+		w.write(m.GetData(), m.NumNonZeroElems() * sizeof(double));
+	}
+	saveToFile(w, getOperatorCacheFilename(directory, key));
+}
+
+std::unique_ptr<MappedFile> buildCachedOperators(
+	const std::string& evolutionName,
+	const std::vector<FiniteElementOperator*>& ops,
+	FiniteElementSpace& fes,
+	const Model& model,
+	const MaxwellEvolOptions& opts,
+	const std::function<void()>& assemble)
+{
+	const auto& cacheDir{ opts.operatorCacheDirectory };
+	if (cacheDir.empty()) {
+		assemble();
+		return nullptr;
+	}
+
+	const auto key{ buildOperatorCacheKey(evolutionName, fes, model, opts) };
+	const auto inPlace{ opts.shareCachedOperators };
+	auto store{ loadOperators(cacheDir, key, ops, fes, inPlace) };
+	if (!store) {
+		assemble();
+		try {
+			saveOperators(cacheDir, key, ops);
+		}
+		catch (const std::runtime_error&) {
+			// Another process may hold the cache file it has just written,
+			// which on Windows prevents replacing it. Its file is then a hit.
+			store = loadOperators(cacheDir, key, ops, fes, inPlace);
+			if (!store) {
+				throw;
+			}
+		}
+		if (inPlace && !store) {
+			store = loadOperators(cacheDir, key, ops, fes, inPlace);
+		}
+	}
+	return inPlace ? std::move(store) : nullptr;
+}
+
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "MaxwellDefs.h"
+#include "MappedFile.h"
+
+namespace maxwell {
+
+/** On disk cache of assembled evolution operators.
+	Each evolution stores its operators, in a fixed order, in a file of the
+	cache directory named after a key. The key hashes the evolution name,
+	the cache format version, the mesh, the materials, boundaries and PMLs
+	of the model, the name of the finite element collection, the ordering
+	of the space and the flux type, which is the only evolution option the
+	assembled matrices depend on. Any change in them leads to a different
+	file. Cached files are memory mapped when read, and files which are
+	truncated or hold inconsistent arrays are ignored and reassembled.
+	Writers use a temporary file of their own which is renamed over the
+	cache file, so processes starting together with a cold cache may all
+	assemble, but never map a partially written file.
+	Arrays in the file are aligned, so operators can also be used in place:
+	their sparse matrices then point to copy on write mapped pages, which
+	are shared by all the processes using the same cache file as long as
+	they are not written.
+	*/
+std::uint64_t buildOperatorCacheKey(const std::string& evolutionName, const mfem::FiniteElementSpace&, const Model&, const MaxwellEvolOptions&);
+std::string getOperatorCacheFilename(const std::string& directory, std::uint64_t key);
+
+// Returns the mapped cache file, or null leaving the operators untouched if
+// there is no valid one for the key. Operators loaded in place point to the
+// mapped file, which must outlive them.
+std::unique_ptr<MappedFile> loadOperators(const std::string& directory, std::uint64_t key, const std::vector<FiniteElementOperator*>&, mfem::FiniteElementSpace&, bool inPlace);
+void saveOperators(const std::string& directory, std::uint64_t key, const std::vector<FiniteElementOperator*>&);
+
+// Loads the operators from the cache directory of the options, or assembles
+// and caches them if needed. Returns the mapping they point to when shared.
+std::unique_ptr<MappedFile> buildCachedOperators(
+	const std::string& evolutionName,
+	const std::vector<FiniteElementOperator*>&, 
+	mfem::FiniteElementSpace&, 
+	const Model&, 
+	const MaxwellEvolOptions&, 
+	const std::function<void()>& assemble);
+
+}
@@ -0,0 +1,228 @@
+#include "ParMaxwellEvolution.h"
+
+#ifdef MFEM_USE_MPI
+
+#include <algorithm>
+
+#include "DispersiveMedia.h"
+#include "MemoryPlacement.h"
+
+namespace maxwell {
+
+using namespace mfem;
+
+// Parallel forms with face integrators have one extra column per face
+// neighbour DoF, placed after the local ones in the order of the face
+// neighbour data of the space.
+static void splitColumns(const SparseMatrix& A, int ndofs, SparseMatrix& interior, SparseMatrix& boundary)
+{
+	const auto height{ A.Height() };
+	const auto* I{ A.GetI() };
+	const auto* J{ A.GetJ() };
+	const auto* a{ A.GetData() };
+
+	SparseMatrix res[2]{ SparseMatrix(height, ndofs), SparseMatrix(height, std::max(A.Width() - ndofs, 0)) };
+	for (int i = 0; i < height; i++) {
+		for (int k = I[i]; k < I[i + 1]; k++) {
+			if (J[k] < ndofs) {
+				res[0].Add(i, J[k], a[k]);
+			}
+			else {
+				res[1].Add(i, J[k] - ndofs, a[k]);
+			}
+		}
+	}
+	res[0].Finalize();
+	res[1].Finalize();
+	interior.Swap(res[0]);
+	boundary.Swap(res[1]);
+}
+
+// M^-1 A, with both forms assembled by each rank on its partition. The
+// inverse mass is block diagonal, so the product needs no communication.
+ParMaxwellEvolution::SplitOperator ParMaxwellEvolution::buildSplitByMult(
+	const BilinearForm& MInv, const BilinearForm& A, int ndofs, const MemoryPlacementOptions& placement)
+{
+	std::unique_ptr<SparseMatrix> product{ mfem::Mult(MInv.SpMat(), A.SpMat()) };
+	SplitOperator res{ std::make_unique<SparseMatrix>(), std::make_unique<SparseMatrix>() };
+	splitColumns(*product, ndofs, *res.interior, *res.boundary);
+	if (placement.firstTouch) {
+		placeByFirstTouch(*res.interior, placement.hugePages);
+		placeByFirstTouch(*res.boundary, placement.hugePages);
+	}
+	return res;
+}
+
+ParMaxwellEvolution::ParMaxwellEvolution(
+	ParFiniteElementSpace& fes, Model& model, const MaxwellEvolOptions& options) :
+	TimeDependentOperator(numberOfFieldComponents * numberOfMaxDimensions * fes.GetNDofs()),
+	fes_{ fes },
+	model_{ model },
+	opts_{ options },
+	layout_{ fes, numberOfFieldComponents * numberOfMaxDimensions }
+{
+	const auto dim{ fes_.GetMesh()->Dimension() };
+	if (dim != 2 && dim != 3) {
+		throw std::runtime_error("The parallel evolution is only available in 2D and 3D.");
+	}
+	if (!model_.getAttributeToPML().empty() || DispersiveMedia::isDispersive(model_)) {
+		throw std::runtime_error("PML regions and dispersive media are not available in the parallel evolution.");
+	}
+	if (opts_.fieldsLayout != FieldsLayout::Blocked) {
+		throw std::runtime_error("The parallel evolution only supports blocked field layouts.");
+	}
+
+	fes_.ExchangeFaceNbrData();
+	assembleOperators();
+	buildTerms();
+	losses_ = buildConductiveLosses(model_, fes_);
+
+	const auto components{ layout_.getNumberOfComponents() };
+	const auto neighbours{ fes_.GetParMesh()->GetNFaceNeighbors() };
+	sendBuffer_.SetSize(components * fes_.send_face_nbr_ldof.Size_of_connections());
+	recvBuffer_.SetSize(components * fes_.GetFaceNbrVSize());
+	for (auto& v : neighbourDofs_) {
+		v.SetSize(fes_.GetFaceNbrVSize());
+	}
+	requests_.resize(2 * neighbours);
+}
+
+void ParMaxwellEvolution::assembleOperators()
+{
+	const auto ndofs{ fes_.GetNDofs() };
+	const auto& placement{ opts_.memoryPlacement };
+	for (auto f : { E, H }) {
+		const auto f2{ altField(f) };
+		MP_[f] = buildSplitByMult(*buildInverseMassMatrix(f, model_, fes_), *buildPenaltyOperator(f, {}, model_, fes_, opts_), ndofs, placement);
+		for (auto d : { X, Y, Z }) {
+			MS_[f][d] = buildSplitByMult(*buildInverseMassMatrix(f, model_, fes_), *buildDerivativeOperator(d, fes_), ndofs, placement);
+			MFN_[f][d] = buildSplitByMult(*buildInverseMassMatrix(f, model_, fes_), *buildFluxOperator(f2, { d }, model_, fes_), ndofs, placement);
+			if (opts_.fluxType != FluxType::Upwind) {
+				continue;
+			}
+			for (auto d2 : { X, Y, Z }) {
+				MFNN_[f][d][d2] = buildSplitByMult(*buildInverseMassMatrix(f, model_, fes_), *buildFluxOperator(f, { d, d2 }, model_, fes_), ndofs, placement);
+			}
+		}
+	}
+}
+
+void ParMaxwellEvolution::buildTerms()
+{
+	// Same terms as MaxwellEvolution3D. The 2D evolution only has Hx, Hy and
+	// Ez, and drops the terms along z, whose derivatives and normals vanish.
+	const auto dim{ fes_.GetMesh()->Dimension() };
+	auto isEvolved = [&](const FieldType& f, const Direction& d) {
+		return dim == 3 || (f == E ? d == Z : d != Z);
+	};
+	auto add = [&](const SplitOperator& op, const OperatorGroup& group, const Direction& along, const FieldType& f, const Direction& c, const FieldType& fIn, const Direction& cIn, double coefficient) {
+		if (along >= dim || !isEvolved(f, c) || !isEvolved(fIn, cIn)) {
+			return;
+		}
+		const auto out{ getComponent(3, f, c) };
+		const auto in{ getComponent(3, fIn, cIn) };
+		interiorTerms_.push_back({ op.interior.get(), out, in, coefficient, group });
+		// Derivatives and forms without shared faces have no boundary part.
+		if (op.boundary->NumNonZeroElems() > 0) {
+			boundaryTerms_.push_back({ op.boundary.get(), out, in, coefficient, group });
+		}
+	};
+
+	for (int x = X; x <= Z; x++) {
+		const auto y{ (x + 1) % 3 };
+		const auto z{ (x + 2) % 3 };
+		add(MS_[H][y],  OperatorGroup::MS,  y, H, x, E, z, -1.0);
+		add(MS_[H][z],  OperatorGroup::MS,  z, H, x, E, y,  1.0);
+		add(MFN_[H][y], OperatorGroup::MFN, y, H, x, E, z,  1.0);
+		add(MFN_[H][z], OperatorGroup::MFN, z, H, x, E, y, -1.0);
+
+		add(MS_[E][y],  OperatorGroup::MS,  y, E, x, H, z,  1.0);
+		add(MS_[E][z],  OperatorGroup::MS,  z, E, x, H, y, -1.0);
+		add(MFN_[E][y], OperatorGroup::MFN, y, E, x, H, z, -1.0);
+		add(MFN_[E][z], OperatorGroup::MFN, z, E, x, H, y,  1.0);
+
+		if (opts_.fluxType == FluxType::Upwind) {
+			for (int d = X; d <= Z; d++) {
+				add(MFNN_[H][d][x], OperatorGroup::MFNN, std::max(d, x), H, x, H, d, 1.0);
+				add(MFNN_[E][d][x], OperatorGroup::MFNN, std::max(d, x), E, x, E, d, 1.0);
+			}
+			add(MP_[H], OperatorGroup::MP, X, H, x, H, x, -1.0);
+			add(MP_[E], OperatorGroup::MP, X, E, x, E, x, -1.0);
+		}
+	}
+	interiorTerms_ = StateLayout::groupByOperator(interiorTerms_);
+}
+
+void ParMaxwellEvolution::startHaloExchange(const Vector& in) const
+{
+	const auto& pmesh{ *fes_.GetParMesh() };
+	const auto components{ layout_.getNumberOfComponents() };
+	const auto* sendOffset{ fes_.send_face_nbr_ldof.GetI() };
+	const auto* sendDofs{ fes_.send_face_nbr_ldof.GetJ() };
+	const auto* recvOffset{ fes_.face_nbr_ldof.GetI() };
+
+	for (int fn = 0; fn < pmesh.GetNFaceNeighbors(); fn++) {
+		const auto sendSize{ sendOffset[fn + 1] - sendOffset[fn] };
+		const auto recvSize{ recvOffset[fn + 1] - recvOffset[fn] };
+		auto* send{ sendBuffer_.GetData() + components * sendOffset[fn] };
+		auto* recv{ recvBuffer_.GetData() + components * recvOffset[fn] };
+		for (int c = 0; c < components; c++) {
+			for (int k = 0; k < sendSize; k++) {
+				send[c * sendSize + k] = in[layout_.index(c, sendDofs[sendOffset[fn] + k])];
+			}
+		}
+		const auto rank{ pmesh.GetFaceNbrRank(fn) };
+		MPI_Irecv(recv, components * recvSize, MPI_DOUBLE, rank, 0, fes_.GetComm(), &requests_[2 * fn]);
+		MPI_Isend(send, components * sendSize, MPI_DOUBLE, rank, 0, fes_.GetComm(), &requests_[2 * fn + 1]);
+	}
+}
+
+void ParMaxwellEvolution::finishHaloExchange() const
+{
+	MPI_Waitall((int) requests_.size(), requests_.data(), MPI_STATUSES_IGNORE);
+
+	const auto components{ layout_.getNumberOfComponents() };
+	const auto* recvOffset{ fes_.face_nbr_ldof.GetI() };
+	for (int fn = 0; fn < fes_.GetParMesh()->GetNFaceNeighbors(); fn++) {
+		const auto recvSize{ recvOffset[fn + 1] - recvOffset[fn] };
+		const auto* recv{ recvBuffer_.GetData() + components * recvOffset[fn] };
+		for (int c = 0; c < components; c++) {
+			for (int k = 0; k < recvSize; k++) {
+				neighbourDofs_[c][recvOffset[fn] + k] = recv[c * recvSize + k];
+			}
+		}
+	}
+}
+
+void ParMaxwellEvolution::Mult(const Vector& in, Vector& out) const
+{
+	startHaloExchange(in);
+
+	// Interior work only reads local DoFs and hides the latency of the exchange.
+	initializeWithLosses(losses_, layout_, { 0, 1, 2 }, in, out);
+	layout_.addMult(interiorTerms_, in, out);
+
+	finishHaloExchange();
+
+	const auto ndofs{ layout_.getNDofs() };
+	std::array<Vector, 6> du;
+	for (int c = 0; c < layout_.getNumberOfComponents(); c++) {
+		du[c].SetDataAndSize(out.GetData() + layout_.index(c, 0), ndofs);
+	}
+	for (const auto& t : boundaryTerms_) {
+		// Same lower bound of the traffic as the terms of StateLayout::addMult.
+		const auto& A{ *t.op };
+		const auto nnz{ double(A.NumNonZeroElems()) };
+		ScopedTimer timer{
+			getRegion(t.group),
+			(double) A.Height(),
+			nnz * (sizeof(double) + sizeof(int)) + (A.Height() + 1.0) * sizeof(int) +
+			(A.Width() + 2.0 * A.Height()) * sizeof(double)
+		};
+		t.op->AddMult(neighbourDofs_[t.cIn], du[t.c], t.coefficient);
+	}
+}
+
+}
+
+#endif
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <mfem.hpp>
+
+#ifdef MFEM_USE_MPI
+
+#include "Types.h"
+#include "Model.h"
+#include "MaxwellDefs.h"
+#include "StateLayout.h"
+
+namespace maxwell {
+
+/** Distributed evolution of the 2D and 3D Maxwell equations.
+	Operators are assembled by each rank on its partition with the same
+	integrators as the serial evolutions. Faces shared with other ranks are
+	assembled through the face neighbour data of the parallel space, so each
+	operator is split in an interior part, acting on local DoFs, and a
+	boundary part, acting on the DoFs of face neighbour elements.
+	Mult posts non-blocking exchanges of the neighbour DoFs of all the
+	components at once, applies the interior parts while messages are in
+	flight and only waits for them before the boundary parts. The state
+	vector holds the local DoFs of the six components, blocked as in
+	MaxwellEvolution3D.
+	*/
+class ParMaxwellEvolution : public mfem::TimeDependentOperator {
+public:
+	static const int numberOfFieldComponents = 2;
+	static const int numberOfMaxDimensions = 3;
+
+	// Columns of local DoFs go to interior, those of neighbour DoFs to boundary.
+	struct SplitOperator {
+		std::unique_ptr<mfem::SparseMatrix> interior;
+		std::unique_ptr<mfem::SparseMatrix> boundary;
+	};
+
+	// M^-1 A of forms of a parallel space, split after its first ndofs columns.
+	static SplitOperator buildSplitByMult(const mfem::BilinearForm& MInv, const mfem::BilinearForm& A, int ndofs, const MemoryPlacementOptions&);
+
+	ParMaxwellEvolution(mfem::ParFiniteElementSpace&, Model&, const MaxwellEvolOptions&);
+	virtual void Mult(const mfem::Vector& x, mfem::Vector& y) const;
+
+	// DoFs of the elements sharing a face with this rank, per component.
+	int getNumberOfNeighbourDofs() const { return fes_.GetFaceNbrVSize(); }
+
+private:
+	mfem::ParFiniteElementSpace& fes_;
+	Model& model_;
+	MaxwellEvolOptions opts_;
+	StateLayout layout_;
+
+	std::array<std::array<SplitOperator, 3>, 2> MS_;
+	std::array<std::array<SplitOperator, 3>, 2> MFN_;
+	std::array<std::array<std::array<SplitOperator, 3>, 3>, 2> MFNN_;
+	std::array<SplitOperator, 2> MP_;
+
+	StateLayout::Terms interiorTerms_;
+	StateLayout::Terms boundaryTerms_;
+	// Conductivity over permittivity per DoF, empty when lossless.
+	mfem::Vector losses_;
+
+	// Messages hold the DoFs of every component, blocked per neighbour.
+	mutable mfem::Vector sendBuffer_, recvBuffer_;
+	mutable std::array<mfem::Vector, 6> neighbourDofs_;
+	mutable std::vector<MPI_Request> requests_;
+
+	void assembleOperators();
+	void buildTerms();
+	void startHaloExchange(const mfem::Vector& in) const;
+	void finishHaloExchange() const;
+};
+
+}
+
+#endif
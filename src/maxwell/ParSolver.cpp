@@ -0,0 +1,183 @@
+#include "ParSolver.h"
+
+#ifdef MFEM_USE_MPI
+
+#include <cmath>
+#include <fstream>
+#include <string>
+
+#include "SourcesManager.h"
+
+namespace maxwell {
+
+using namespace mfem;
+
+static int getRank(MPI_Comm comm)
+{
+	int res;
+	MPI_Comm_rank(comm, &res);
+	return res;
+}
+
+static int getSize(MPI_Comm comm)
+{
+	int res;
+	MPI_Comm_size(comm, &res);
+	return res;
+}
+
+ParSolver::ParSolver(
+	MPI_Comm comm,
+	Model model,
+	const Probes& probes,
+	const Sources& sources,
+	const SolverOptions& options) :
+	comm_{ comm },
+	rank_{ getRank(comm) },
+	size_{ getSize(comm) },
+	opts_{ options },
+	mesh_{ comm, model.getMesh() },
+	model_{ Model::buildView(mesh_, model.getAttributeToMaterial(), model.getAttributeToBoundary(), model.getAttributeToPML()) },
+	fec_{ opts_.order, mesh_.Dimension(), BasisType::GaussLobatto },
+	fes_{ &mesh_, &fec_ },
+	fields_{ fes_ },
+	probes_{ probes }
+{
+	ProfilerScope profiling{ profiler_ };
+	checkProblemIsSupported(probes, sources);
+
+	SourcesManager{ sources, fes_ }.setFields3D(fields_);
+	evolution_ = std::make_unique<ParMaxwellEvolution>(fes_, model_, opts_.evolutionOperatorOptions);
+	evolution_->SetTime(time_);
+	odeSolver_.Init(*evolution_);
+
+	buildProbes();
+	updateProbes();
+}
+
+void ParSolver::checkProblemIsSupported(const Probes& probes, const Sources& sources) const
+{
+	if (!opts_.restartFrom.empty() || !opts_.checkpoint.filename.empty()) {
+		throw std::runtime_error("Checkpoints are not available in the parallel solver.");
+	}
+	if (!probes.xdmfExporterProbes.empty() || !probes.dftProbes.empty() ||
+		!probes.fieldDFTProbes.empty() || !probes.gridProbes.empty() ||
+		!probes.energyProbes.empty() || !probes.poyntingFluxProbes.empty() ||
+		!probes.nearToFarFieldProbes.empty() || probes.samplingSchedule.period > 0.0 ||
+		!probes.samplingSchedule.times.empty()) {
+		throw std::runtime_error("The parallel solver only supports points and exporter probes sampled every visSteps.");
+	}
+	for (const auto& source : sources) {
+		if (source->isTimeDependent()) {
+			throw std::runtime_error("Time dependent sources are not available in the parallel solver.");
+		}
+	}
+}
+
+void ParSolver::buildProbes()
+{
+	const auto dim{ mesh_.Dimension() };
+	for (const auto& p : probes_.pointsProbes) {
+		const auto& points{ p.getPoints() };
+		DenseMatrix pointMat(dim, (int) points.size());
+		for (int i = 0; i < pointMat.Width(); i++) {
+			for (int d = 0; d < dim; d++) {
+				pointMat(d, i) = points[i][d];
+			}
+		}
+
+		// Each point is assigned to the lowest rank holding it, other ranks get -1.
+		Array<int> elems;
+		Array<IntegrationPoint> ips;
+		if (mesh_.FindPoints(pointMat, elems, ips, false) < pointMat.Width()) {
+			throw std::runtime_error("Probe points could not be located in the mesh.");
+		}
+
+		auto interpolator{ std::make_unique<SparseMatrix>(pointMat.Width(), fes_.GetNDofs()) };
+		Array<int> dofs;
+		Vector shape;
+		for (int i = 0; i < elems.Size(); i++) {
+			if (elems[i] < 0) {
+				continue;
+			}
+			const auto* fe{ fes_.GetFE(elems[i]) };
+			fes_.GetElementDofs(elems[i], dofs);
+			shape.SetSize(fe->GetDof());
+			fe->CalcShape(ips[i], shape);
+			for (int j = 0; j < dofs.Size(); j++) {
+				interpolator->Add(i, dofs[j], shape[j]);
+			}
+		}
+		interpolator->Finalize();
+		pointsInterpolators_.push_back(std::move(interpolator));
+	}
+
+	for (const auto& p : probes_.exporterProbes) {
+		if (p.options.hasRegion()) {
+			throw std::runtime_error("Region restricted export is only available for XDMF exporter probes.");
+		}
+		auto pd{ std::make_unique<ParaViewDataCollection>(p.name, &mesh_) };
+		pd->SetPrefixPath("ParaView");
+		for (const auto& c : buildExportedComponents(p.options, dim)) {
+			pd->RegisterField(getComponentName(c, dim), &fields_.get(c.fieldType, c.direction));
+		}
+		const auto lod{ p.options.levelsOfDetail > 0 ? p.options.levelsOfDetail : opts_.order };
+		pd->SetLevelsOfDetail(lod);
+		pd->SetHighOrderOutput(lod > 0);
+		pd->SetDataFormat(p.options.singlePrecision ? VTKFormat::BINARY32 : VTKFormat::BINARY);
+		exporters_.push_back(std::move(pd));
+	}
+}
+
+const PointsProbe& ParSolver::getPointsProbe(const std::size_t probe) const
+{
+	return probes_.pointsProbes.at(probe);
+}
+
+void ParSolver::updateProbes()
+{
+	if (cycle_++ % probes_.visSteps != 0) {
+		return;
+	}
+
+	for (std::size_t i{ 0 }; i < probes_.pointsProbes.size(); i++) {
+		auto& p{ probes_.pointsProbes[i] };
+		const auto& interpolator{ *pointsInterpolators_[i] };
+		Vector local(interpolator.Height());
+		interpolator.Mult(fields_.get(p.getFieldType(), p.getDirection()), local);
+
+		FieldFrame frame(local.Size());
+		MPI_Reduce(local.GetData(), frame.data(), local.Size(), MPI_DOUBLE, MPI_SUM, 0, comm_);
+		if (rank_ == 0) {
+			p.addFrame(time_, frame);
+		}
+	}
+
+	for (auto& pd : exporters_) {
+		pd->SetCycle(cycle_ - 1);
+		pd->SetTime(time_);
+		pd->Save();
+	}
+}
+
+void ParSolver::run()
+{
+	ProfilerScope profiling{ profiler_ };
+	while (std::abs(time_ - opts_.t_final) < 1e-6 || time_ < opts_.t_final) {
+		odeSolver_.Step(fields_.allDOFs, time_, opts_.dt);
+		updateProbes();
+	}
+
+	if (!opts_.performanceReport.empty()) {
+		const auto filename{ size_ == 1 ? opts_.performanceReport : opts_.performanceReport + "." + std::to_string(rank_) };
+		std::ofstream out{ filename, std::ios::trunc };
+		if (!out) {
+			throw std::runtime_error("Could not open performance report " + filename);
+		}
+		out << getPerformanceReport().toJSON();
+	}
+}
+
+}
+
+#endif
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <mfem.hpp>
+
+#ifdef MFEM_USE_MPI
+
+#include "Types.h"
+#include "Fields.h"
+#include "Probes.h"
+#include "Sources.h"
+#include "SolverOptions.h"
+#include "DenseRK4Solver.h"
+#include "ParMaxwellEvolution.h"
+#include "Profiler.h"
+
+namespace maxwell {
+
+/** Distributed memory solver for 2D and 3D problems.
+	The mesh of the model is partitioned among the ranks of the communicator
+	and each rank evolves the fields of its elements with a
+	ParMaxwellEvolution, so the problem size is bounded by the memory of all
+	the nodes instead of one. Initial fields are set by every rank on its own
+	DoFs. Points of points probes are sampled by the lowest rank holding them
+	and reduced to rank 0, the only rank storing the frames. Exporter probes
+	write one piece per rank and a parallel ParaView file tying them. Other
+	probes and time dependent sources are only available in Solver.
+	The model is taken by value: its serial mesh is only used to build the
+	partitions and is released when the constructor returns. Each rank
+	keeps a model with the same attributes which refers to its partition
+	instead of copying it.
+	Performance reports only count the work of each rank: when requested,
+	every rank writes its own, suffixed with ".<rank>" if there are several.
+	*/
+class ParSolver {
+public:
+	ParSolver(MPI_Comm, Model, const Probes&, const Sources&, const SolverOptions& = SolverOptions());
+	ParSolver(const ParSolver&) = delete;
+	ParSolver& operator=(const ParSolver&) = delete;
+
+	// Frames are only stored in rank 0.
+	const PointsProbe& getPointsProbe(const std::size_t probe) const;
+	// Fields of the elements of this rank.
+	const Fields& getFields() const { return fields_; }
+	double getTime() const { return time_; }
+	int getRank() const { return rank_; }
+	int getNumberOfRanks() const { return size_; }
+	// DoFs of all the ranks, per field component.
+	HYPRE_BigInt getGlobalNDofs() const { return fes_.GlobalTrueVSize(); }
+	// Time per phase and operator group of this rank since construction.
+	PerformanceReport getPerformanceReport() const { return profiler_.buildReport(); }
+
+	void run();
+
+private:
+	MPI_Comm comm_;
+	int rank_, size_;
+
+	SolverOptions opts_;
+	Profiler profiler_;
+	mfem::ParMesh mesh_;
+	Model model_;
+	mfem::DG_FECollection fec_;
+	mfem::ParFiniteElementSpace fes_;
+	Fields fields_;
+
+	Probes probes_;
+	// Rows of points held by other ranks are empty.
+	std::vector<std::unique_ptr<mfem::SparseMatrix>> pointsInterpolators_;
+	std::vector<std::unique_ptr<mfem::ParaViewDataCollection>> exporters_;
+
+	std::unique_ptr<ParMaxwellEvolution> evolution_;
+	DenseRK4Solver odeSolver_;
+	double time_{ 0.0 };
+	int cycle_{ 0 };
+
+	void checkProblemIsSupported(const Probes&, const Sources&) const;
+	void buildProbes();
+	void updateProbes();
+};
+
+}
+
+#endif
@@ -0,0 +1,151 @@
+#include "PerfectlyMatchedLayer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace maxwell {
+
+using namespace mfem;
+
+static const double defaultReflection{ 1e-6 };
+
+PerfectlyMatchedLayer::PerfectlyMatchedLayer(
+	FiniteElementSpace& fes, 
+	const Model& model, 
+	const std::vector<Term>& terms, 
+	const DerivativeOperators& MS, 
+	const FluxOperators& MFN,
+	const StateLayout& layout) :
+	fes_{ fes },
+	layout_{ layout },
+	terms_{ terms },
+	auxiliaryOffset_{ layout.getSize() }
+{
+	buildConductivities(model);
+
+	for (const auto& t : terms_) {
+		auto& K{ K_[t.f][t.d] };
+		if (K) {
+			continue;
+		}
+		const auto& S{ MS[t.f][t.d]->SpMat() };
+		const auto& F{ MFN[t.f][altField(t.f)][t.d]->SpMat() };
+		K = std::make_unique<SparseMatrix>(dofs_.Size(), fes_.GetNDofs());
+		for (int i = 0; i < dofs_.Size(); i++) {
+			const auto row{ dofs_[i] };
+			for (int k = S.GetI()[row]; k < S.GetI()[row + 1]; k++) {
+				K->Add(i, S.GetJ()[k], S.GetData()[k]);
+			}
+			for (int k = F.GetI()[row]; k < F.GetI()[row + 1]; k++) {
+				K->Add(i, F.GetJ()[k], -F.GetData()[k]);
+			}
+		}
+		K->Finalize();
+	}
+}
+
+void PerfectlyMatchedLayer::buildConductivities(const Model& model)
+{
+	auto& mesh{ *fes_.GetMesh() };
+	const auto& pmls{ model.getAttributeToPML() };
+	const auto dim{ mesh.SpaceDimension() };
+
+	// The layer spans from the box of the non PML elements to the mesh box.
+	Point inMin(dim, std::numeric_limits<double>::max()), inMax(dim, std::numeric_limits<double>::lowest());
+	Point meshMin{ inMin }, meshMax{ inMax };
+	Array<int> vertices;
+	for (int e = 0; e < mesh.GetNE(); e++) {
+		const auto isPML{ pmls.count(mesh.GetAttribute(e)) != 0 };
+		mesh.GetElementVertices(e, vertices);
+		for (const auto& v : vertices) {
+			const auto* x{ mesh.GetVertex(v) };
+			for (int d = 0; d < dim; d++) {
+				meshMin[d] = std::min(meshMin[d], x[d]);
+				meshMax[d] = std::max(meshMax[d], x[d]);
+				if (!isPML) {
+					inMin[d] = std::min(inMin[d], x[d]);
+					inMax[d] = std::max(inMax[d], x[d]);
+				}
+			}
+		}
+	}
+	if (inMin[0] > inMax[0]) {
+		throw std::runtime_error("PML regions can not cover the whole mesh.");
+	}
+
+	std::vector<double> sigmas[3];
+	Array<int> elemDofs;
+	Vector pos;
+	for (int e = 0; e < mesh.GetNE(); e++) {
+		const auto it{ pmls.find(mesh.GetAttribute(e)) };
+		if (it == pmls.end()) {
+			continue;
+		}
+		const auto& region{ it->second };
+		const auto m{ region.profileOrder };
+
+		const auto* fe{ fes_.GetFE(e) };
+		auto* T{ mesh.GetElementTransformation(e) };
+		fes_.GetElementDofs(e, elemDofs);
+		for (int i = 0; i < elemDofs.Size(); i++) {
+			T->Transform(fe->GetNodes().IntPoint(i), pos);
+			dofs_.Append(elemDofs[i]);
+			for (int d = 0; d < 3; d++) {
+				double depth{ 0.0 }, thickness{ 0.0 };
+				if (d < dim && pos[d] > inMax[d]) {
+					depth = pos[d] - inMax[d];
+					thickness = meshMax[d] - inMax[d];
+				}
+				else if (d < dim && pos[d] < inMin[d]) {
+					depth = inMin[d] - pos[d];
+					thickness = inMin[d] - meshMin[d];
+				}
+
+				double sigma{ 0.0 };
+				if (depth > 0.0) {
+					auto maxSigma{ region.maxConductivity };
+					if (maxSigma <= 0.0) {
+						maxSigma = -(m + 1) * std::log(defaultReflection) / (2.0 * thickness);
+					}
+					sigma = maxSigma * std::pow(depth / thickness, m);
+				}
+				sigmas[d].push_back(sigma);
+			}
+		}
+	}
+
+	for (int d = 0; d < 3; d++) {
+		sigma_[d].SetSize((int) sigmas[d].size());
+		std::copy(sigmas[d].begin(), sigmas[d].end(), sigma_[d].GetData());
+	}
+}
+
+void PerfectlyMatchedLayer::addTerms(const Vector& in, Vector& out) const
+{
+	const auto nPML{ dofs_.Size() };
+	for (std::size_t t{ 0 }; t < terms_.size(); t++) {
+		const auto& term{ terms_[t] };
+		const auto cIn{ getComponent(3, term.fIn, term.cIn) };
+		const auto c{ getComponent(3, term.f, term.c) };
+		const auto* psi{ in.GetData() + auxiliaryOffset_ + t * nPML };
+		auto* dPsi{ out.GetData() + auxiliaryOffset_ + t * nPML };
+		const auto& sigma{ sigma_[term.d] };
+
+		// Rows of K only read the input DoFs they couple, in place for any layout.
+		const auto& K{ *K_[term.f][term.d] };
+		const auto* I{ K.GetI() };
+		const auto* J{ K.GetJ() };
+		const auto* a{ K.GetData() };
+		for (int i = 0; i < nPML; i++) {
+			double derivative{ 0.0 };
+			for (int k = I[i]; k < I[i + 1]; k++) {
+				derivative += a[k] * in[layout_.index(cIn, J[k])];
+			}
+			out[layout_.index(c, dofs_[i])] += term.sign * psi[i];
+			dPsi[i] = -sigma[i] * (psi[i] + derivative);
+		}
+	}
+}
+
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <mfem.hpp>
+
+#include "MaxwellDefs.h"
+#include "Model.h"
+#include "StateLayout.h"
+
+namespace maxwell {
+
+/** Stretched coordinates perfectly matched layer for the 2D and 3D evolutions.
+	Each spatial derivative d/dx_d appearing in the curl equations is
+	replaced inside the layer by (1/s_d) d/dx_d with s_d = 1 + sigma_d/(j w).
+	This is written as the unstretched term plus an auxiliary field psi
+	which follows
+		d psi / dt = - sigma_d (psi + D_d u),
+	where D_d is the centered derivative operator of the evolution,
+	M^-1 (S_d - F_d), restricted to the rows of the layer DoFs. Auxiliary
+	fields only exist for the layer DoFs and are stored after the field
+	components in the state vector. Conductivities grow polynomially from
+	the boundary of the non PML elements to the end of the mesh.
+	*/
+class PerfectlyMatchedLayer {
+public:
+	// Term of the evolution, out_(f, c) += sign * D_(f, d) in_(fIn, cIn).
+	struct Term {
+		FieldType f;
+		Direction c;
+		Direction d;
+		FieldType fIn;
+		Direction cIn;
+		double sign;
+	};
+
+	using DerivativeOperators = std::array<std::array<FiniteElementOperator, 3>, 2>;
+	using FluxOperators = std::array<std::array<std::array<FiniteElementOperator, 3>, 2>, 2>;
+
+	PerfectlyMatchedLayer(mfem::FiniteElementSpace&, const Model&, const std::vector<Term>&, const DerivativeOperators& MS, const FluxOperators& MFN, const StateLayout&);
+
+	int getNumberOfAuxiliaryDOFs() const { return (int) terms_.size() * dofs_.Size(); }
+
+	// Adds the auxiliary terms to the field derivatives and sets the derivatives of the auxiliary fields.
+	void addTerms(const mfem::Vector& in, mfem::Vector& out) const;
+
+private:
+	mfem::FiniteElementSpace& fes_;
+	const StateLayout& layout_;
+	std::vector<Term> terms_;
+	int auxiliaryOffset_;
+
+	mfem::Array<int> dofs_;
+	std::array<mfem::Vector, 3> sigma_;
+	std::array<std::array<std::unique_ptr<mfem::SparseMatrix>, 3>, 2> K_;
+
+	void buildConductivities(const Model&);
+};
+
+}
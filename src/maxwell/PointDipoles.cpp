@@ -0,0 +1,104 @@
+#include "PointDipoles.h"
+#include "PointLocator.h"
+
+namespace maxwell {
+
+using namespace mfem;
+
+PointDipoles::PointDipoles(
+	FiniteElementSpace& fes, 
+	const Model& model, 
+	const Sources& sources, 
+	const PointSourceType& type,
+	const StateLayout& layout) :
+	type_{ type }
+{
+	auto& mesh{ *fes.GetMesh() };
+	const auto dim{ mesh.Dimension() };
+
+	std::vector<const PointDipole*> dipoles;
+	Points positions;
+	for (const auto& source : sources) {
+		const auto* dipole{ dynamic_cast<const PointDipole*>(source.get()) };
+		if (!dipole || dipole->getType() != type_) {
+			continue;
+		}
+		if (dipole->center.Size() < dim) {
+			throw std::runtime_error("Point dipole position has less components than the mesh dimension.");
+		}
+		dipoles.push_back(dipole);
+		positions.push_back(Point(dipole->center.GetData(), dipole->center.GetData() + dim));
+	}
+	if (dipoles.empty()) {
+		return;
+	}
+
+	const auto locations{ PointLocator{ mesh }.locate(positions) };
+	const auto& materials{ model.getAttributeToMaterial() };
+	DenseMatrix mass;
+	for (std::size_t i{ 0 }; i < dipoles.size(); i++) {
+		const auto& dipole{ *dipoles[i] };
+		const auto e{ locations[i].elementId };
+		const auto* fe{ fes.GetFE(e) };
+		auto* T{ mesh.GetElementTransformation(e) };
+
+		double coefficient{ 1.0 };
+		const auto it{ materials.find(mesh.GetAttribute(e)) };
+		if (it != materials.end()) {
+			coefficient = dipole.fieldType == E ? it->second.getPermittivity() : it->second.getPermeability();
+		}
+		ConstantCoefficient c{ coefficient };
+		MassIntegrator{ c }.AssembleElementMatrix(*fe, *T, mass);
+
+		Dipole d{ std::shared_ptr<Waveform>(dipole.getWaveform().clone()), dipole.getMoment() };
+		fes.GetElementDofs(e, d.dofs);
+		const auto component{ getComponent(dim, dipole.fieldType, dipole.direction) };
+		for (auto& dof : d.dofs) {
+			dof = layout.index(component, dof);
+		}
+		d.shape.SetSize(fe->GetDof());
+		fe->CalcShape(locations[i].iP, d.shape);
+		d.values.SetSize(fe->GetDof());
+		DenseMatrixInverse{ mass }.Mult(d.shape, d.values);
+
+		if (type_ == PointSourceType::Soft) {
+			d.values *= -d.moment;
+		}
+		else {
+			d.values /= d.shape * d.values;
+		}
+		dipoles_.push_back(std::move(d));
+	}
+}
+
+void PointDipoles::addTerms(const Time& time, Vector& out) const
+{
+	if (type_ != PointSourceType::Soft) {
+		return;
+	}
+	for (const auto& d : dipoles_) {
+		const auto g{ d.waveform->eval(time) };
+		for (int i = 0; i < d.dofs.Size(); i++) {
+			out[d.dofs[i]] += g * d.values[i];
+		}
+	}
+}
+
+void PointDipoles::imposeHardSources(const Time& time, Vector& state) const
+{
+	if (type_ != PointSourceType::Hard) {
+		return;
+	}
+	for (const auto& d : dipoles_) {
+		double value{ 0.0 };
+		for (int i = 0; i < d.dofs.Size(); i++) {
+			value += d.shape[i] * state[d.dofs[i]];
+		}
+		const auto correction{ d.moment * d.waveform->eval(time) - value };
+		for (int i = 0; i < d.dofs.Size(); i++) {
+			state[d.dofs[i]] += correction * d.values[i];
+		}
+	}
+}
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <mfem.hpp>
+
+#include "Model.h"
+#include "Sources.h"
+#include "SourceTerm.h"
+
+namespace maxwell {
+
+/** Point dipoles of one type among a set of sources.
+	Dipoles are located in bulk when built and only touch the DoFs of their
+	element afterwards, so their cost does not depend on the mesh size.
+	A soft dipole is the current moment g(t) delta(x - x0), whose
+	contribution to the field derivative is
+		- moment g(t) M^-1 phi(x0),
+	with M the element mass matrix weighted by the material coefficient and
+	phi the element shape functions. Hard dipoles correct the element field
+	after each step, along M^-1 phi(x0) which is the smallest correction in
+	the M norm, so that its value at x0 is exactly moment g(t).
+	*/
+class PointDipoles : public SourceTerm {
+public:
+	PointDipoles(mfem::FiniteElementSpace&, const Model&, const Sources&, const PointSourceType&, const StateLayout&);
+
+	bool empty() const { return dipoles_.empty(); }
+
+	// Adds the currents of soft dipoles.
+	void addTerms(const Time&, mfem::Vector& out) const;
+	// Sets the field at the position of hard dipoles.
+	void imposeHardSources(const Time&, mfem::Vector& state) const;
+
+private:
+	struct Dipole {
+		std::shared_ptr<Waveform> waveform;
+		double moment;
+		mfem::Array<int> dofs;
+		mfem::Vector shape;
+		// Soft: - moment M^-1 phi(x0). Hard: M^-1 phi(x0) / (phi(x0)^T M^-1 phi(x0)).
+		mfem::Vector values;
+	};
+
+	PointSourceType type_;
+	std::vector<Dipole> dipoles_;
+};
+
+}
@@ -0,0 +1,159 @@
+#include "PointLocator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace maxwell {
+
+using namespace mfem;
+
+static const double boxRelativePadding{ 1e-6 };
+static const double referenceTolerance{ 1e-10 };
+
+PointLocator::PointLocator(Mesh& mesh) :
+	mesh_{ mesh },
+	dim_{ mesh.SpaceDimension() },
+	isCurved_{ mesh.GetNodes() != nullptr }
+{
+	// Element boxes are computed from refined points so curved elements are covered.
+	std::vector<BoundingBox> elemBoxes(mesh_.GetNE());
+	meshBox_ = {
+		Point(dim_, std::numeric_limits<double>::max()),
+		Point(dim_, std::numeric_limits<double>::lowest())
+	};
+	IsoparametricTransformation T;
+	DenseMatrix pos;
+	for (int e = 0; e < mesh_.GetNE(); e++) {
+		mesh_.GetElementTransformation(e, &T);
+		const auto* refGeom{ GlobGeometryRefiner.Refine(mesh_.GetElementBaseGeometry(e), 2) };
+		T.Transform(refGeom->RefPts, pos);
+
+		auto& box{ elemBoxes[e] };
+		box = { Point(dim_, std::numeric_limits<double>::max()), Point(dim_, std::numeric_limits<double>::lowest()) };
+		for (int i = 0; i < pos.Width(); i++) {
+			for (int d = 0; d < dim_; d++) {
+				box.min[d] = std::min(box.min[d], pos(d, i));
+				box.max[d] = std::max(box.max[d], pos(d, i));
+			}
+		}
+		for (int d = 0; d < dim_; d++) {
+			const auto pad{ boxRelativePadding * (box.max[d] - box.min[d]) + std::numeric_limits<double>::epsilon() };
+			box.min[d] -= pad;
+			box.max[d] += pad;
+			meshBox_.min[d] = std::min(meshBox_.min[d], box.min[d]);
+			meshBox_.max[d] = std::max(meshBox_.max[d], box.max[d]);
+		}
+	}
+
+	const auto binsPerDim{ std::max(1, (int) std::ceil(std::pow(mesh_.GetNE(), 1.0 / dim_))) };
+	binsPerDim_.assign(dim_, binsPerDim);
+	binSize_.resize(dim_);
+	auto numberOfBins{ 1 };
+	for (int d = 0; d < dim_; d++) {
+		binSize_[d] = (meshBox_.max[d] - meshBox_.min[d]) / binsPerDim_[d];
+		numberOfBins *= binsPerDim_[d];
+	}
+	bins_.resize(numberOfBins);
+
+	for (int e = 0; e < mesh_.GetNE(); e++) {
+		const auto lo{ getBinCoordinates(elemBoxes[e].min) };
+		const auto hi{ getBinCoordinates(elemBoxes[e].max) };
+		std::vector<int> ijk{ lo };
+		while (true) {
+			bins_[getBinIndex(ijk)].push_back(e);
+			int d = 0;
+			for (; d < dim_; d++) {
+				if (++ijk[d] <= hi[d]) {
+					break;
+				}
+				ijk[d] = lo[d];
+			}
+			if (d == dim_) {
+				break;
+			}
+		}
+	}
+}
+
+int PointLocator::getBinIndex(const std::vector<int>& ijk) const
+{
+	auto res{ 0 };
+	for (int d = dim_ - 1; d >= 0; d--) {
+		res = res * binsPerDim_[d] + ijk[d];
+	}
+	return res;
+}
+
+std::vector<int> PointLocator::getBinCoordinates(const Point& p) const
+{
+	std::vector<int> res(dim_);
+	for (int d = 0; d < dim_; d++) {
+		const auto i{ binSize_[d] > 0.0 ? (int) std::floor((p[d] - meshBox_.min[d]) / binSize_[d]) : 0 };
+		res[d] = std::min(std::max(i, 0), binsPerDim_[d] - 1);
+	}
+	return res;
+}
+
+bool PointLocator::locateInElement(int e, const Point& p, IsoparametricTransformation& T, IntegrationPoint& ip) const
+{
+	// T is owned by the caller, the shared transformation of the mesh is never used.
+	mesh_.GetElementTransformation(e, &T);
+	InverseElementTransformation inv{ &T };
+	inv.SetReferenceTol(referenceTolerance);
+	// Newton from the element center does not converge on strongly curved
+	// elements, which start from their closest node instead.
+	inv.SetInitialGuessType(isCurved_ ?
+		InverseElementTransformation::ClosestPhysNode :
+		InverseElementTransformation::Center);
+
+	Vector pt(dim_);
+	for (int d = 0; d < dim_; d++) {
+		pt[d] = p[d];
+	}
+	if (inv.Transform(pt, ip) == InverseElementTransformation::Outside) {
+		return false;
+	}
+	return Geometry::CheckPoint(mesh_.GetElementBaseGeometry(e), ip, std::sqrt(referenceTolerance));
+}
+
+std::vector<PointLocator::Location> PointLocator::locate(const Points& points) const
+{
+	std::vector<Location> res(points.size(), Location{ -1, IntegrationPoint() });
+
+	// Closest node guesses refine elements through the global GlobGeometryRefiner,
+	// which is not thread safe, so curved meshes are located serially.
+	#pragma omp parallel for schedule(dynamic, 64) if(!isCurved_)
+	for (int i = 0; i < (int) points.size(); i++) {
+		const auto& p{ points[i] };
+		if (p.size() != (std::size_t) dim_) {
+			continue;
+		}
+		bool isInMeshBox{ true };
+		for (int d = 0; d < dim_; d++) {
+			isInMeshBox &= p[d] >= meshBox_.min[d] && p[d] <= meshBox_.max[d];
+		}
+		if (!isInMeshBox) {
+			continue;
+		}
+
+		IsoparametricTransformation T;
+		IntegrationPoint ip;
+		// Bins store elements in increasing order, the first hit has the lowest index.
+		for (const auto& e : bins_[getBinIndex(getBinCoordinates(p))]) {
+			if (locateInElement(e, p, T, ip)) {
+				res[i] = { e, ip };
+				break;
+			}
+		}
+	}
+
+	for (std::size_t i{ 0 }; i < res.size(); i++) {
+		if (res[i].elementId < 0) {
+			throw std::runtime_error("Point " + std::to_string(i) + " could not be located in the mesh.");
+		}
+	}
+	return res;
+}
+
+}
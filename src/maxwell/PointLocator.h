@@ -0,0 +1,50 @@
+#pragma once
+
+#include <mfem.hpp>
+
+#include "Types.h"
+
+namespace maxwell {
+
+/** Bulk point location over a mesh.
+	Element bounding boxes are binned once in a uniform grid, so locating a
+	point only requires inverting the transformations of the few elements
+	whose boxes overlap its bin. Points lying on faces shared by several
+	elements are assigned to the element with the lowest index, which keeps
+	the result independent of traversal order and threading. Each thread
+	inverts its own element transformations, and meshes with curved
+	elements are located serially.
+	*/
+class PointLocator {
+public:
+	struct Location {
+		int elementId;
+		mfem::IntegrationPoint iP;
+	};
+
+	PointLocator(mfem::Mesh&);
+
+	// Throws if any point is outside the mesh.
+	std::vector<Location> locate(const Points&) const;
+
+private:
+	struct BoundingBox {
+		Point min, max;
+	};
+
+	mfem::Mesh& mesh_;
+	int dim_;
+	// Meshes with nodes have curved elements.
+	bool isCurved_;
+
+	BoundingBox meshBox_;
+	std::vector<int> binsPerDim_;
+	std::vector<double> binSize_;
+	std::vector<std::vector<int>> bins_;
+
+	int getBinIndex(const std::vector<int>& ijk) const;
+	std::vector<int> getBinCoordinates(const Point&) const;
+	bool locateInElement(int e, const Point&, mfem::IsoparametricTransformation&, mfem::IntegrationPoint&) const;
+};
+
+}
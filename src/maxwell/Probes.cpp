@@ -1,6 +1,9 @@
 #include "Probes.h"
 #include <algorithm>
 
+#define _USE_MATH_DEFINES
+#include <math.h>
+
 using namespace mfem;
 
 namespace maxwell {
@@ -36,4 +39,202 @@ PointsProbe::PointsProbe(const FieldType& ft, const Direction& d, const Points&
 	checkPointsHaveSameSize(points);
 }
 
+GridProbe::GridProbe(
+	const FieldType& ft, 
+	const Direction& d, 
+	const Point& origin, 
+	const Points& steps, 
+	const std::vector<int>& shape, 
+	const std::string& name) :
+	fieldToExtract_{ ft },
+	directionToExtract_{ d },
+	origin_{ origin },
+	steps_{ steps },
+	shape_{ shape },
+	name_{ name }
+{
+	if (origin.empty() || steps.empty() || steps.size() > 3) {
+		throw std::runtime_error("Grid probes need an origin and between one and three axes.");
+	}
+	if (steps.size() != shape.size()) {
+		throw std::runtime_error("Grid probe steps and shape must have the same size.");
+	}
+	for (std::size_t a{ 0 }; a < steps.size(); a++) {
+		if (steps[a].size() != origin.size()) {
+			throw std::runtime_error("Grid probe steps must have the dimension of the origin.");
+		}
+		if (shape[a] < 1) {
+			throw std::runtime_error("Grid probe shape must be positive.");
+		}
+	}
+}
+
+Point buildStep(const Point& begin, const Point& end, int numberOfPoints)
+{
+	if (begin.size() != end.size()) {
+		throw std::runtime_error("Grid probe bounds must have the same dimension.");
+	}
+	Point res(begin.size(), 0.0);
+	if (numberOfPoints > 1) {
+		for (std::size_t d{ 0 }; d < begin.size(); d++) {
+			res[d] = (end[d] - begin[d]) / (numberOfPoints - 1);
+		}
+	}
+	return res;
+}
+
+GridProbe GridProbe::line(const FieldType& ft, const Direction& d, const Point& begin, const Point& end, int n, const std::string& name)
+{
+	return GridProbe(ft, d, begin, { buildStep(begin, end, n) }, { n }, name);
+}
+
+GridProbe GridProbe::plane(const FieldType& ft, const Direction& d, const Point& origin, const Point& u, const Point& v, int nu, int nv, const std::string& name)
+{
+	Point uEnd{ origin }, vEnd{ origin };
+	for (std::size_t i{ 0 }; i < origin.size() && i < u.size() && i < v.size(); i++) {
+		uEnd[i] += u[i];
+		vEnd[i] += v[i];
+	}
+	return GridProbe(ft, d, origin, { buildStep(origin, uEnd, nu), buildStep(origin, vEnd, nv) }, { nu, nv }, name);
+}
+
+GridProbe GridProbe::grid(const FieldType& ft, const Direction& d, const Point& boxMin, const Point& boxMax, const std::vector<int>& shape, const std::string& name)
+{
+	if (boxMin.size() != shape.size() || boxMax.size() != shape.size()) {
+		throw std::runtime_error("Grid probe shape must have the dimension of the box.");
+	}
+	Points steps;
+	for (std::size_t a{ 0 }; a < shape.size(); a++) {
+		Point end{ boxMin };
+		end[a] = boxMax[a];
+		steps.push_back(buildStep(boxMin, end, shape[a]));
+	}
+	return GridProbe(ft, d, boxMin, steps, shape, name);
+}
+
+Points GridProbe::buildPoints() const
+{
+	std::vector<int> n{ shape_ };
+	n.resize(3, 1);
+	Points res;
+	res.reserve(n[0] * n[1] * n[2]);
+	for (int k = 0; k < n[2]; k++) {
+		for (int j = 0; j < n[1]; j++) {
+			for (int i = 0; i < n[0]; i++) {
+				Point p{ origin_ };
+				const std::array<int, 3> ijk{ i, j, k };
+				for (std::size_t a{ 0 }; a < steps_.size(); a++) {
+					for (std::size_t d{ 0 }; d < p.size(); d++) {
+						p[d] += ijk[a] * steps_[a][d];
+					}
+				}
+				res.push_back(p);
+			}
+		}
+	}
+	return res;
+}
+
+void checkFrequenciesAreValid(const Frequencies& frequencies)
+{
+	if (frequencies.empty()) {
+		throw std::runtime_error("Empty frequencies vector.");
+	}
+	for (const auto& f : frequencies) {
+		if (f < 0.0) {
+			throw std::runtime_error("Negative frequencies are not allowed.");
+		}
+	}
+}
+
+DFTProbe::DFTProbe(const FieldType& ft, const Direction& d, const Points& points, const Frequencies& frequencies) :
+	fieldToExtract_{ ft },
+	directionToExtract_{ d },
+	points_{ points },
+	frequencies_{ frequencies },
+	transform_(points.size(), std::vector<std::complex<double>>(frequencies.size(), 0.0))
+{
+	if (points.size() == 0) {
+		throw std::runtime_error("Empty points vector.");
+	}
+	checkPointsAreNotEmpty(points);
+	checkPointsHaveSameSize(points);
+	checkFrequenciesAreValid(frequencies);
+}
+
+FieldDFTProbe::FieldDFTProbe(const FieldType& ft, const Direction& d, const Frequencies& frequencies) :
+	fieldToExtract_{ ft },
+	directionToExtract_{ d },
+	frequencies_{ frequencies }
+{
+	checkFrequenciesAreValid(frequencies);
+}
+
+NearToFarFieldProbe::NearToFarFieldProbe(
+	const std::vector<Attribute>& bdrAttributes, 
+	const Frequencies& frequencies, 
+	const SphericalDirections& directions,
+	Attribute interiorAttribute) :
+	attributes_{ bdrAttributes },
+	frequencies_{ frequencies },
+	directions_{ directions },
+	interiorAttribute_{ interiorAttribute }
+{
+	if (bdrAttributes.empty()) {
+		throw std::runtime_error("Near to far field probes need at least one boundary attribute.");
+	}
+	if (directions.empty()) {
+		throw std::runtime_error("Empty directions vector.");
+	}
+	checkFrequenciesAreValid(frequencies);
+
+	vectors_.assign(frequencies.size(), std::vector<RadiationVectors>(directions.size()));
+}
+
+FarField NearToFarFieldProbe::getFarField(std::size_t f, std::size_t d) const
+{
+	const auto& v{ vectors_.at(f).at(d) };
+	const auto& dir{ directions_.at(d) };
+	const double ct{ cos(dir.theta) }, st{ sin(dir.theta) }, cp{ cos(dir.phi) }, sp{ sin(dir.phi) };
+	auto toTheta = [&](const ComplexVector3& a) { return a[X] * ct * cp + a[Y] * ct * sp - a[Z] * st; };
+	auto toPhi   = [&](const ComplexVector3& a) { return -a[X] * sp + a[Y] * cp; };
+
+	const double eta{ 1.0 };
+	const auto k{ 2.0 * M_PI * frequencies_[f] };
+	const std::complex<double> factor{ 0.0, k / (4.0 * M_PI) };
+	return {
+		-factor * (toPhi(v.L) + eta * toTheta(v.N)),
+		 factor * (toTheta(v.L) - eta * toPhi(v.N))
+	};
+}
+
+PoyntingFluxProbe::PoyntingFluxProbe(const std::vector<Attribute>& bdrAttributes, Attribute interiorAttribute) :
+	attributes_{ bdrAttributes },
+	interiorAttribute_{ interiorAttribute }
+{
+	if (bdrAttributes.empty()) {
+		throw std::runtime_error("Poynting flux probes need at least one boundary attribute.");
+	}
+}
+
+std::vector<FieldComponent> buildExportedComponents(const ExporterOptions& opts, int dimension)
+{
+	if (!opts.components.empty()) {
+		return opts.components;
+	}
+	if (dimension == 1) {
+		return { {E, X}, {H, X} };
+	}
+	return { {E, X}, {E, Y}, {E, Z}, {H, X}, {H, Y}, {H, Z} };
+}
+
+std::string getComponentName(const FieldComponent& c, int dimension)
+{
+	std::string res{ c.fieldType == E ? "E" : "H" };
+	if (dimension > 1) {
+		res += std::string{ "xyz" }.at(c.direction);
+	}
+	return res;
+}
+
 }
\ No newline at end of file
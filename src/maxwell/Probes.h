@@ -1,18 +1,57 @@
 #pragma once
 
+#include <array>
+#include <complex>
 #include <mfem.hpp>
 
 #include "Types.h"
 
 namespace maxwell {
 
+struct FieldComponent {
+    FieldType fieldType;
+    Direction direction;
+};
+
+struct ExporterOptions {
+    // Empty vectors export all components and all elements.
+    std::vector<FieldComponent> components;
+    std::vector<Attribute> attributes;
+    // Only elements overlapping the box are exported. Empty disables it,
+    // otherwise both corners need one coordinate per mesh dimension.
+    Point boxMin, boxMax;
+    // Non positive levels of detail default to the FES order.
+    int levelsOfDetail{ 0 };
+    // Only applies to field arrays, geometry is always written in double
+    // precision as it is written once and shared by all snapshots.
+    bool singlePrecision{ false };
+
+    bool hasRegion() const { return !attributes.empty() || !boxMin.empty(); }
+};
+
+std::vector<FieldComponent> buildExportedComponents(const ExporterOptions&, int dimension);
+std::string getComponentName(const FieldComponent&, int dimension);
+
 struct ExporterProbe {
 public:
-    ExporterProbe(const std::string& name) :
-        name{ name }
+    ExporterProbe(const std::string& name, const ExporterOptions& options = ExporterOptions{}) :
+        name{ name },
+        options{ options }
+    {}
+
+    std::string name{"MaxwellView"};
+    ExporterOptions options;
+};
+
+struct XDMFExporterProbe {
+public:
+    XDMFExporterProbe(const std::string& name, const ExporterOptions& options = ExporterOptions{}) :
+        name{ name },
+        options{ options }
     {}
 
     std::string name{"MaxwellView"};
+    ExporterOptions options;
 };
 
 class PointsProbe {
@@ -33,11 +72,223 @@ private:
     FieldMovie fieldMovie_;
 };
 
+/** Samples a field component on a structured lattice of points,
+	    origin + i * steps[0] + j * steps[1] + k * steps[2],
+	with the first axis running fastest. Lines, planes and grids are lattices
+	with one, two and three axes. When a name is given, frames are streamed
+	to <name>.bin as records of the time followed by the lattice values, and
+	<name>.json describes the layout. Otherwise frames are kept in memory.
+	*/
+class GridProbe {
+public:
+    GridProbe(const FieldType&, const Direction&, const Point& origin, const Points& steps, const std::vector<int>& shape, const std::string& name = "");
+
+    static GridProbe line(const FieldType&, const Direction&, const Point& begin, const Point& end, int numberOfPoints, const std::string& name = "");
+    static GridProbe plane(const FieldType&, const Direction&, const Point& origin, const Point& u, const Point& v, int nu, int nv, const std::string& name = "");
+    static GridProbe grid(const FieldType&, const Direction&, const Point& boxMin, const Point& boxMax, const std::vector<int>& shape, const std::string& name = "");
+
+    const FieldType& getFieldType() const { return fieldToExtract_; }
+    const Direction& getDirection() const { return directionToExtract_; }
+    const Point& getOrigin() const { return origin_; }
+    const Points& getSteps() const { return steps_; }
+    const std::vector<int>& getShape() const { return shape_; }
+    const std::string& getName() const { return name_; }
+    const FieldMovie& getFieldMovie() const { return fieldMovie_; }
+    void addFrame(double time, const FieldFrame& frame) { fieldMovie_.emplace(time, frame); };
+
+    Points buildPoints() const;
+
+private:
+    FieldType fieldToExtract_;
+    Direction directionToExtract_;
+    Point origin_;
+    Points steps_;
+    std::vector<int> shape_;
+    std::string name_;
+
+    FieldMovie fieldMovie_;
+};
+
+using Frequencies = std::vector<double>;
+using PointsTransform = std::vector<std::vector<std::complex<double>>>;
+
+/** Running discrete Fourier transform of a field component at a set of points.
+	The transform is accumulated every time step for each of the frequencies,
+	so memory scales with points x frequencies and not with the run length.
+	*/
+class DFTProbe {
+public:
+    DFTProbe(const FieldType&, const Direction&, const Points&, const Frequencies&);
+
+    const FieldType& getFieldType() const { return fieldToExtract_; }
+    const Direction& getDirection() const { return directionToExtract_; }
+    const Points& getPoints() const { return points_; }
+    const Frequencies& getFrequencies() const { return frequencies_; }
+    // Indexed as [point][frequency].
+    const PointsTransform& getTransform() const { return transform_; }
+    PointsTransform& getTransform() { return transform_; }
+
+private:
+    FieldType fieldToExtract_;
+    Direction directionToExtract_;
+    Points points_;
+    Frequencies frequencies_;
+
+    PointsTransform transform_;
+};
+
+/** Running discrete Fourier transform of a field component over all DoFs. */
+class FieldDFTProbe {
+public:
+    FieldDFTProbe(const FieldType&, const Direction&, const Frequencies&);
+
+    const FieldType& getFieldType() const { return fieldToExtract_; }
+    const Direction& getDirection() const { return directionToExtract_; }
+    const Frequencies& getFrequencies() const { return frequencies_; }
+    // One vector of DoFs per frequency.
+    const std::vector<mfem::Vector>& getReal() const { return real_; }
+    const std::vector<mfem::Vector>& getImag() const { return imag_; }
+    std::vector<mfem::Vector>& getReal() { return real_; }
+    std::vector<mfem::Vector>& getImag() { return imag_; }
+
+private:
+    FieldType fieldToExtract_;
+    Direction directionToExtract_;
+    Frequencies frequencies_;
+
+    std::vector<mfem::Vector> real_, imag_;
+};
+
+struct SphericalDirection {
+    double theta;
+    double phi;
+};
+
+using SphericalDirections = std::vector<SphericalDirection>;
+using ComplexVector3 = std::array<std::complex<double>, 3>;
+
+// Electric and magnetic radiation vectors in cartesian components.
+struct RadiationVectors {
+    ComplexVector3 N{};
+    ComplexVector3 L{};
+};
+
+// Far field E * r * exp(jkr) in spherical components.
+struct FarField {
+    std::complex<double> theta;
+    std::complex<double> phi;
+};
+
+/** Near to far field transformation over a closed surface given by a set of
+	boundary or interface attributes. The surface equivalent currents
+	J = n x H and M = -n x E are transformed on the fly each time step into
+	the radiation vectors of every frequency and direction, so no surface or
+	volume field history is kept. The spatial phase of every surface node,
+	frequency and direction is computed once. On exterior boundaries normals
+	point out of the domain, surfaces made of interior faces need the
+	attribute of the elements they enclose, as in PoyntingFluxProbe, so the
+	surface may have any shape. The medium outside the surface is assumed
+	to be vacuum in normalized units, eta = c = 1.
+	*/
+class NearToFarFieldProbe {
+public:
+    NearToFarFieldProbe(const std::vector<Attribute>& bdrAttributes, const Frequencies&, const SphericalDirections&, Attribute interiorAttribute = 0);
+
+    const std::vector<Attribute>& getAttributes() const { return attributes_; }
+    // Zero when the surface only has exterior boundaries.
+    Attribute getInteriorAttribute() const { return interiorAttribute_; }
+    const Frequencies& getFrequencies() const { return frequencies_; }
+    const SphericalDirections& getDirections() const { return directions_; }
+    // Indexed as [frequency][direction].
+    const std::vector<std::vector<RadiationVectors>>& getRadiationVectors() const { return vectors_; }
+    std::vector<std::vector<RadiationVectors>>& getRadiationVectors() { return vectors_; }
+
+    FarField getFarField(std::size_t frequency, std::size_t direction) const;
+
+private:
+    std::vector<Attribute> attributes_;
+    Frequencies frequencies_;
+    SphericalDirections directions_;
+    Attribute interiorAttribute_;
+
+    std::vector<std::vector<RadiationVectors>> vectors_;
+};
+
+struct Energy {
+    double electric{ 0.0 };
+    double magnetic{ 0.0 };
+
+    double total() const { return electric + magnetic; }
+};
+
+using EnergyMovie = std::map<Time, Energy>;
+using ScalarMovie = std::map<Time, double>;
+
+/** Electromagnetic energy stored in the elements of a set of attributes.
+	An empty set of attributes integrates over the whole mesh. Energies are
+	evaluated as u^T M u with the consistent mass matrix of the selected
+	elements scaled by their permittivity and permeability, assembled once.
+	*/
+class EnergyProbe {
+public:
+    EnergyProbe(const std::vector<Attribute>& attributes = {}) :
+        attributes_{ attributes }
+    {}
+
+    const std::vector<Attribute>& getAttributes() const { return attributes_; }
+    const EnergyMovie& getEnergyMovie() const { return energyMovie_; }
+    void addFrame(double time, const Energy& energy) { energyMovie_.emplace(time, energy); };
+
+private:
+    std::vector<Attribute> attributes_;
+
+    EnergyMovie energyMovie_;
+};
+
+/** Flux of the Poynting vector through the faces of a set of boundary
+	attributes. On exterior boundaries the normal points out of the domain.
+	Interior interfaces need the attribute of the elements on their inner
+	side, the flux being positive when leaving those elements.
+	*/
+class PoyntingFluxProbe {
+public:
+    PoyntingFluxProbe(const std::vector<Attribute>& bdrAttributes, Attribute interiorAttribute = 0);
+
+    const std::vector<Attribute>& getAttributes() const { return attributes_; }
+    // Zero when the probe only crosses exterior boundaries.
+    Attribute getInteriorAttribute() const { return interiorAttribute_; }
+    const ScalarMovie& getFluxMovie() const { return fluxMovie_; }
+    void addFrame(double time, double flux) { fluxMovie_.emplace(time, flux); };
+
+private:
+    std::vector<Attribute> attributes_;
+    Attribute interiorAttribute_;
+
+    ScalarMovie fluxMovie_;
+};
+
+struct SamplingSchedule {
+    // Fixed sampling period. Non positive values disable it.
+    double period{ 0.0 };
+    std::vector<Time> times;
+
+    bool isTimeBased() const { return period > 0.0 || !times.empty(); }
+};
+
 struct Probes {
     std::vector<PointsProbe> pointsProbes;
     std::vector<ExporterProbe> exporterProbes;
+    std::vector<XDMFExporterProbe> xdmfExporterProbes;
+    std::vector<DFTProbe> dftProbes;
+    std::vector<FieldDFTProbe> fieldDFTProbes;
+    std::vector<GridProbe> gridProbes;
+    std::vector<EnergyProbe> energyProbes;
+    std::vector<PoyntingFluxProbe> poyntingFluxProbes;
+    std::vector<NearToFarFieldProbe> nearToFarFieldProbes;
 
     int visSteps{ 10 };
+    // When time based, replaces visSteps and samples at exact times.
+    SamplingSchedule samplingSchedule;
 };
 
 }
\ No newline at end of file
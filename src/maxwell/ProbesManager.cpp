@@ -1,48 +1,127 @@
 #include "ProbesManager.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+#define _USE_MATH_DEFINES
+#include <math.h>
 
 namespace maxwell {
 
 using namespace mfem;
 
+// Surfaces with interior faces are oriented by the attribute of the elements they enclose.
+static SurfaceQuadrature buildProbeSurfaceQuadrature(const FiniteElementSpace& fes, const std::vector<Attribute>& atts, Attribute interiorAttribute)
+{
+	return interiorAttribute == 0 ?
+		buildSurfaceQuadrature(fes, atts) :
+		buildSurfaceQuadrature(fes, atts, interiorAttribute);
+}
+
 ParaViewDataCollection ProbesManager::buildParaviewDataCollection(const ExporterProbe& p, Fields& fields) const
 {
+	if (p.options.hasRegion()) {
+		throw std::runtime_error("Region restricted export is only available for XDMF exporter probes.");
+	}
+
 	ParaViewDataCollection pd{ p.name, fes_.GetMesh()};
 	pd.SetPrefixPath("ParaView");
 	
-	switch (fes_.GetMesh()->Dimension()) {
-	case 1:
-		pd.RegisterField("E", &fields.E1D);
-		pd.RegisterField("H", &fields.H1D);
-		break;
-	default:
-		pd.RegisterField("Ex", &fields.E[X]);
-		pd.RegisterField("Ey", &fields.E[Y]);
-		pd.RegisterField("Ez", &fields.E[Z]);
-		pd.RegisterField("Hx", &fields.H[X]);
-		pd.RegisterField("Hy", &fields.H[Y]);
-		pd.RegisterField("Hz", &fields.H[Z]);
-		break;
+	const auto dim{ fes_.GetMesh()->Dimension() };
+	for (const auto& c : buildExportedComponents(p.options, dim)) {
+		pd.RegisterField(getComponentName(c, dim), &fields.get(c.fieldType, c.direction));
 	}
 
 	const auto order{ fes_.GetMaxElementOrder() };
-	pd.SetLevelsOfDetail(order);
-	order > 0 ? pd.SetHighOrderOutput(true) : pd.SetHighOrderOutput(false);
+	const auto lod{ p.options.levelsOfDetail > 0 ? p.options.levelsOfDetail : order };
+	pd.SetLevelsOfDetail(lod);
+	lod > 0 ? pd.SetHighOrderOutput(true) : pd.SetHighOrderOutput(false);
 	
-	pd.SetDataFormat(VTKFormat::BINARY);
+	pd.SetDataFormat(p.options.singlePrecision ? VTKFormat::BINARY32 : VTKFormat::BINARY);
 
 	return pd;
 }
 
-ProbesManager::ProbesManager(Probes probes, const mfem::FiniteElementSpace& fes, Fields& fields) :
+ProbesManager::ProbesManager(Probes probes, const mfem::FiniteElementSpace& fes, Fields& fields, const AttributeToMaterial& materials) :
 	probes_{probes},
-	fes_{fes}
+	fes_{fes},
+	fields_{fields}
 {
+	const auto& schedule{ probes_.samplingSchedule };
+	scheduledTimes_ = schedule.times;
+	std::sort(scheduledTimes_.begin(), scheduledTimes_.end());
+	if (!scheduledTimes_.empty() && scheduledTimes_.front() < 0.0) {
+		throw std::runtime_error("Sampling times must be non negative.");
+	}
+
 	for (const auto& p: probes_.exporterProbes) {
 		exporterProbesCollection_.emplace(&p, buildParaviewDataCollection(p, fields));
 	}
+
+	for (const auto& p : probes_.xdmfExporterProbes) {
+		xdmfExporterProbesCollection_.emplace(
+			std::piecewise_construct,
+			std::forward_as_tuple(&p),
+			std::forward_as_tuple(p.name, p.options, fes_, fields)
+		);
+	}
 	
+	// All probe points are located in a single pass.
+	Points points;
+	for (const auto& p : probes_.pointsProbes) {
+		points.insert(points.end(), p.getPoints().begin(), p.getPoints().end());
+	}
+	for (const auto& p : probes_.dftProbes) {
+		points.insert(points.end(), p.getPoints().begin(), p.getPoints().end());
+	}
+	std::vector<Points> gridPoints;
+	for (const auto& p : probes_.gridProbes) {
+		gridPoints.push_back(p.buildPoints());
+		points.insert(points.end(), gridPoints.back().begin(), gridPoints.back().end());
+	}
+	const auto locations{ points.empty() ? Locations{} : getPointLocator().locate(points) };
+	auto loc{ locations.begin() };
 	for (const auto& p : probes_.pointsProbes) {
-		pointProbesCollection_.emplace(&p, buildPointsProbeCollection(p, fields));
+		const Locations probeLocations{ loc, loc + p.getPoints().size() };
+		pointProbesCollection_.emplace(&p, buildPointsProbeCollection(p, probeLocations, fields));
+		loc += p.getPoints().size();
+	}
+	for (const auto& p : probes_.dftProbes) {
+		const Locations probeLocations{ loc, loc + p.getPoints().size() };
+		dftProbesCollection_.emplace(&p, buildPointsProbeCollection(p, probeLocations, fields));
+		loc += p.getPoints().size();
+	}
+	for (std::size_t i{ 0 }; i < probes_.gridProbes.size(); i++) {
+		const auto& p{ probes_.gridProbes[i] };
+		const Locations probeLocations{ loc, loc + gridPoints[i].size() };
+		gridProbesCollection_.emplace(&p, buildGridProbeCollection(p, probeLocations, fields));
+		loc += gridPoints[i].size();
+	}
+
+	for (auto& p : probes_.fieldDFTProbes) {
+		for (auto* v : { &p.getReal(), &p.getImag() }) {
+			v->assign(p.getFrequencies().size(), Vector(fes_.GetNDofs()));
+			for (auto& f : *v) {
+				f = 0.0;
+			}
+		}
+	}
+
+	for (const auto& p : probes_.energyProbes) {
+		energyProbesCollection_.emplace(&p, buildEnergyProbeCollection(p, materials));
+	}
+	for (const auto& p : probes_.poyntingFluxProbes) {
+		poyntingFluxProbesCollection_.emplace(&p, buildProbeSurfaceQuadrature(fes_, p.getAttributes(), p.getInteriorAttribute()));
+	}
+	for (const auto& p : probes_.nearToFarFieldProbes) {
+		if (fes_.GetMesh()->Dimension() != 3) {
+			throw std::runtime_error("Near to far field probes are only available in 3D.");
+		}
+		nearToFarFieldProbesCollection_.emplace(&p, buildNearToFarFieldProbeCollection(p));
 	}
 }
 
@@ -52,95 +131,631 @@ const PointsProbe& ProbesManager::getPointsProbe(const std::size_t i) const
 	return probes_.pointsProbes[i];
 }
 
-const GridFunction& getFieldView(const PointsProbe& p, const mfem::FiniteElementSpace& fes, Fields& fields)
+const GridProbe& ProbesManager::getGridProbe(const std::size_t i) const
 {
-	switch (p.getFieldType()) {
-	case FieldType::E:
-		switch (fes.GetMesh()->Dimension()) {
-		case 1:
-			return fields.E1D;
-			break;
-		default:
-			return fields.E[p.getDirection()];
-			break;
+	assert(i < probes_.gridProbes.size());
+	return probes_.gridProbes[i];
+}
+
+const DFTProbe& ProbesManager::getDFTProbe(const std::size_t i) const
+{
+	assert(i < probes_.dftProbes.size());
+	return probes_.dftProbes[i];
+}
+
+const FieldDFTProbe& ProbesManager::getFieldDFTProbe(const std::size_t i) const
+{
+	assert(i < probes_.fieldDFTProbes.size());
+	return probes_.fieldDFTProbes[i];
+}
+
+const NearToFarFieldProbe& ProbesManager::getNearToFarFieldProbe(const std::size_t i) const
+{
+	assert(i < probes_.nearToFarFieldProbes.size());
+	return probes_.nearToFarFieldProbes[i];
+}
+
+const EnergyProbe& ProbesManager::getEnergyProbe(const std::size_t i) const
+{
+	assert(i < probes_.energyProbes.size());
+	return probes_.energyProbes[i];
+}
+
+const PoyntingFluxProbe& ProbesManager::getPoyntingFluxProbe(const std::size_t i) const
+{
+	assert(i < probes_.poyntingFluxProbes.size());
+	return probes_.poyntingFluxProbes[i];
+}
+
+template <class P>
+const GridFunction& getFieldView(const P& p, Fields& fields)
+{
+	return fields.get(p.getFieldType(), p.getDirection());
+}
+
+const PointLocator& ProbesManager::getPointLocator() const
+{
+	if (!pointLocator_) {
+		pointLocator_ = std::make_unique<PointLocator>(*fes_.GetMesh());
+	}
+	return *pointLocator_;
+}
+
+std::unique_ptr<SparseMatrix> ProbesManager::buildInterpolator(const Locations& locations) const
+{
+	auto res{ std::make_unique<SparseMatrix>((int) locations.size(), fes_.GetNDofs()) };
+	Array<int> dofs;
+	Vector shape;
+	for (int i = 0; i < locations.size(); i++) {
+		const auto* fe{ fes_.GetFE(locations[i].elementId) };
+		fes_.GetElementDofs(locations[i].elementId, dofs);
+		shape.SetSize(fe->GetDof());
+		fe->CalcShape(locations[i].iP, shape);
+		for (int j = 0; j < dofs.Size(); j++) {
+			res->Add(i, dofs[j], shape[j]);
 		}
-	case FieldType::H:
-		switch (fes.GetMesh()->Dimension()) {
-		case 1:
-			return fields.H1D;
-			break;
-		default:
-			return fields.H[p.getDirection()];
-			break;
+	}
+	res->Finalize();
+	return res;
+}
+
+template <class P>
+ProbesManager::PointsProbeCollection
+ProbesManager::buildPointsProbeCollection(const P& p, const Locations& locations, Fields& fields) const
+{
+	return { 
+		buildInterpolator(locations),
+		getFieldView(p, fields)
+	};
+}
+
+void writeGridProbeDescriptor(const GridProbe& p, int dimension)
+{
+	auto toJSON = [](const std::vector<double>& v) {
+		std::stringstream ss;
+		ss << std::setprecision(17) << "[";
+		for (std::size_t i{ 0 }; i < v.size(); i++) {
+			ss << (i == 0 ? "" : ", ") << v[i];
 		}
-	default:
-		throw std::runtime_error("Invalid field type.");
+		ss << "]";
+		return ss.str();
+	};
+
+	std::ofstream out{ p.getName() + ".json", std::ios::trunc };
+	out << "{\n";
+	out << "  \"field\": \"" << getComponentName({ p.getFieldType(), p.getDirection() }, dimension) << "\",\n";
+	out << "  \"data\": \"" << p.getName() << ".bin\",\n";
+	out << "  \"record\": \"float64 time followed by float64 values, first axis fastest\",\n";
+	out << "  \"shape\": " << toJSON({ p.getShape().begin(), p.getShape().end() }) << ",\n";
+	out << "  \"origin\": " << toJSON(p.getOrigin()) << ",\n";
+	out << "  \"steps\": [";
+	for (std::size_t a{ 0 }; a < p.getSteps().size(); a++) {
+		out << (a == 0 ? "" : ", ") << toJSON(p.getSteps()[a]);
 	}
+	out << "]\n";
+	out << "}\n";
 }
 
-DenseMatrix toDenseMatrix(const Point& p)
+void openGridProbeFile(const GridProbe& p, std::ofstream& out, std::ios::openmode mode)
 {
-	DenseMatrix r{ 1, (int)p.size() };
-	for (auto i{ 0 }; i < p.size(); ++i) {
-		r(0, i) = p[i];
+	out.open(p.getName() + ".bin", std::ios::binary | mode);
+	if (!out) {
+		throw std::runtime_error("Could not open grid probe file " + p.getName() + ".bin");
 	}
-	return r;
 }
 
-ProbesManager::PointsProbeCollection
-ProbesManager::buildPointsProbeCollection(const PointsProbe& p, Fields& fields) const
+ProbesManager::GridProbeCollection
+ProbesManager::buildGridProbeCollection(const GridProbe& p, const Locations& locations, Fields& fields) const
 {
-	std::vector<FESPoint> fesPoints;
-	for (const auto& point : p.getPoints()) {
-		Array<int> elemIdArray;
-		Array<IntegrationPoint> integPointArray;
-		fes_.GetMesh()->FindPoints(toDenseMatrix(point), elemIdArray, integPointArray);
-		assert(elemIdArray.Size() == 1);
-		assert(integPointArray.Size() == 1);
-		fesPoints.push_back({ elemIdArray[0], integPointArray[0] });
+	std::unique_ptr<std::ofstream> out;
+	if (!p.getName().empty()) {
+		writeGridProbeDescriptor(p, fes_.GetMesh()->Dimension());
+		// Opened on the first frame, so a restart can append to it instead.
+		out = std::make_unique<std::ofstream>();
 	}
-	
-	return { 
-		fesPoints, 
-		getFieldView(p, fes_, fields)
+	return {
+		buildInterpolator(locations),
+		getFieldView(p, fields),
+		std::move(out)
 	};
 }
 
+ProbesManager::EnergyProbeCollection
+ProbesManager::buildEnergyProbeCollection(const EnergyProbe& p, const AttributeToMaterial& materials) const
+{
+	EnergyProbeCollection res{
+		std::make_unique<SparseMatrix>(fes_.GetVSize()),
+		std::make_unique<SparseMatrix>(fes_.GetVSize())
+	};
+
+	const Material vacuum{ 1.0, 1.0 };
+	const auto& atts{ p.getAttributes() };
+	auto& mesh{ *fes_.GetMesh() };
+	MassIntegrator mass;
+	DenseMatrix elMat, scaled;
+	Array<int> dofs;
+	for (int e = 0; e < mesh.GetNE(); e++) {
+		const auto att{ mesh.GetAttribute(e) };
+		if (!atts.empty() && std::find(atts.begin(), atts.end(), att) == atts.end()) {
+			continue;
+		}
+		const auto* mat{ &vacuum };
+		if (!materials.empty()) {
+			const auto it{ materials.find(att) };
+			if (it == materials.end()) {
+				throw std::runtime_error("No material defined for attribute " + std::to_string(att) + ".");
+			}
+			mat = &it->second;
+		}
+
+		// Consistent element mass, so that u^T M u is the exact L2 norm of u.
+		fes_.GetElementVDofs(e, dofs);
+		mass.AssembleElementMatrix(*fes_.GetFE(e), *mesh.GetElementTransformation(e), elMat);
+		scaled.Set(0.5 * mat->getPermittivity(), elMat);
+		res.electricMass->AddSubMatrix(dofs, dofs, scaled);
+		scaled.Set(0.5 * mat->getPermeability(), elMat);
+		res.magneticMass->AddSubMatrix(dofs, dofs, scaled);
+	}
+	res.electricMass->Finalize();
+	res.magneticMass->Finalize();
+	return res;
+}
+
+ProbesManager::NearToFarFieldProbeCollection
+ProbesManager::buildNearToFarFieldProbeCollection(const NearToFarFieldProbe& p) const
+{
+	NearToFarFieldProbeCollection res{ buildProbeSurfaceQuadrature(fes_, p.getAttributes(), p.getInteriorAttribute()), {} };
+	const auto& q{ res.quadrature };
+
+	// With c = 1 the phase of each node is omega * (rHat . r' - t), the time
+	// rotation is applied once per frequency and direction on each update.
+	const auto& freqs{ p.getFrequencies() };
+	const auto& dirs{ p.getDirections() };
+	res.phases.assign(freqs.size(), std::vector<std::vector<std::complex<double>>>(dirs.size()));
+	for (std::size_t f{ 0 }; f < freqs.size(); f++) {
+		const auto omega{ 2.0 * M_PI * freqs[f] };
+		for (std::size_t d{ 0 }; d < dirs.size(); d++) {
+			const double rHat[3]{
+				sin(dirs[d].theta) * cos(dirs[d].phi),
+				sin(dirs[d].theta) * sin(dirs[d].phi),
+				cos(dirs[d].theta)
+			};
+			auto& phases{ res.phases[f][d] };
+			phases.reserve(q.size());
+			for (const auto& r : q.positions) {
+				phases.push_back(std::polar(1.0, omega * (rHat[X] * r[X] + rHat[Y] * r[Y] + rHat[Z] * r[Z])));
+			}
+		}
+	}
+	return res;
+}
+
+std::vector<Direction> getFieldDirections(int dimension)
+{
+	if (dimension == 1) {
+		return { X };
+	}
+	return { X, Y, Z };
+}
+
 void ProbesManager::updateProbe(ExporterProbe& p, double time)
 {
 	auto it{ exporterProbesCollection_.find(&p) };
 	assert(it != exporterProbesCollection_.end());
 	auto& pd{ it->second };
 
+	ScopedTimer timer{ ProfiledRegion::Export };
 	pd.SetCycle(cycle_);
 	pd.SetTime(time);
 	pd.Save();
 }
 
+void ProbesManager::updateProbe(XDMFExporterProbe& p, double time)
+{
+	auto it{ xdmfExporterProbesCollection_.find(&p) };
+	assert(it != xdmfExporterProbesCollection_.end());
+	ScopedTimer timer{ ProfiledRegion::Export };
+	it->second.save(time);
+}
+
 void ProbesManager::updateProbe(PointsProbe& p, double time)
 {
 	const auto& it{ pointProbesCollection_.find(&p) };
 	assert(it != pointProbesCollection_.end());
 	const auto& pC{ it->second };
 
-	FieldFrame frame;
-	for (const auto& fesPoint: pC.fesPoints) {
-		frame.push_back( pC.field.GetValue(fesPoint.elementId, fesPoint.iP) );
-	}
+	FieldFrame frame(pC.interpolator->Height());
+	Vector values{ frame.data(), (int) frame.size() };
+	pC.interpolator->Mult(pC.field, values);
 	
 	p.addFrame(time, frame);
 }
 
+void ProbesManager::updateProbe(GridProbe& p, double time)
+{
+	const auto& it{ gridProbesCollection_.find(&p) };
+	assert(it != gridProbesCollection_.end());
+	auto& pC{ it->second };
+
+	FieldFrame frame(pC.interpolator->Height());
+	Vector values{ frame.data(), (int) frame.size() };
+	pC.interpolator->Mult(pC.field, values);
+
+	if (pC.out) {
+		if (!pC.out->is_open()) {
+			openGridProbeFile(p, *pC.out, std::ios::trunc);
+		}
+		pC.out->write(reinterpret_cast<const char*>(&time), sizeof(double));
+		pC.out->write(reinterpret_cast<const char*>(frame.data()), frame.size() * sizeof(double));
+		pC.out->flush();
+	}
+	else {
+		p.addFrame(time, frame);
+	}
+}
+
+void ProbesManager::updateProbe(DFTProbe& p, double time, double weight)
+{
+	const auto& it{ dftProbesCollection_.find(&p) };
+	assert(it != dftProbesCollection_.end());
+	const auto& pC{ it->second };
+
+	pointValues_.SetSize(pC.interpolator->Height());
+	pC.interpolator->Mult(pC.field, pointValues_);
+
+	const auto& freqs{ p.getFrequencies() };
+	auto& transform{ p.getTransform() };
+	for (std::size_t f{ 0 }; f < freqs.size(); f++) {
+		const auto phase{ std::polar(weight, -2.0 * M_PI * freqs[f] * time) };
+		for (int i = 0; i < pointValues_.Size(); i++) {
+			transform[i][f] += pointValues_[i] * phase;
+		}
+	}
+}
+
+void ProbesManager::updateProbe(FieldDFTProbe& p, Fields& fields, double time, double weight)
+{
+	const auto& field{ getFieldView(p, fields) };
+	const auto& freqs{ p.getFrequencies() };
+	for (std::size_t f{ 0 }; f < freqs.size(); f++) {
+		const auto arg{ 2.0 * M_PI * freqs[f] * time };
+		p.getReal()[f].Add( weight * cos(arg), field);
+		p.getImag()[f].Add(-weight * sin(arg), field);
+	}
+}
+
+void ProbesManager::updateProbe(EnergyProbe& p, double time)
+{
+	const auto& it{ energyProbesCollection_.find(&p) };
+	assert(it != energyProbesCollection_.end());
+	const auto& pC{ it->second };
+
+	Energy energy;
+	for (const auto& d : getFieldDirections(fes_.GetMesh()->Dimension())) {
+		energy.electric += pC.electricMass->InnerProduct(fields_.get(E, d), fields_.get(E, d));
+		energy.magnetic += pC.magneticMass->InnerProduct(fields_.get(H, d), fields_.get(H, d));
+	}
+	p.addFrame(time, energy);
+}
+
+void ProbesManager::updateProbe(PoyntingFluxProbe& p, double time)
+{
+	const auto& it{ poyntingFluxProbesCollection_.find(&p) };
+	assert(it != poyntingFluxProbesCollection_.end());
+	const auto& q{ it->second };
+
+	double flux{ 0.0 };
+	if (fes_.GetMesh()->Dimension() == 1) {
+		const auto& e{ fields_.get(E, X) };
+		const auto& h{ fields_.get(H, X) };
+		for (std::size_t k{ 0 }; k < q.size(); k++) {
+			flux += q.normalWeights[k][X] * e[q.dofs[k]] * h[q.dofs[k]];
+		}
+	}
+	else {
+		const auto& e{ fields_.E };
+		const auto& h{ fields_.H };
+		for (std::size_t k{ 0 }; k < q.size(); k++) {
+			const auto i{ q.dofs[k] };
+			const auto& n{ q.normalWeights[k] };
+			flux += n[X] * (e[Y][i] * h[Z][i] - e[Z][i] * h[Y][i]);
+			flux += n[Y] * (e[Z][i] * h[X][i] - e[X][i] * h[Z][i]);
+			flux += n[Z] * (e[X][i] * h[Y][i] - e[Y][i] * h[X][i]);
+		}
+	}
+	p.addFrame(time, flux);
+}
+
+void ProbesManager::updateProbe(NearToFarFieldProbe& p, double time, double weight)
+{
+	const auto& it{ nearToFarFieldProbesCollection_.find(&p) };
+	assert(it != nearToFarFieldProbesCollection_.end());
+	const auto& q{ it->second.quadrature };
+
+	// Equivalent currents are evaluated once per node, J = n x H and M = -n x E.
+	const auto& e{ fields_.E };
+	const auto& h{ fields_.H };
+	auto cross = [](const Point& n, const std::array<GridFunction, 3>& f, int i) {
+		return std::array<double, 3>{
+			n[Y] * f[Z][i] - n[Z] * f[Y][i],
+			n[Z] * f[X][i] - n[X] * f[Z][i],
+			n[X] * f[Y][i] - n[Y] * f[X][i]
+		};
+	};
+	std::vector<std::array<double, 3>> J(q.size()), M(q.size());
+	for (std::size_t k{ 0 }; k < q.size(); k++) {
+		J[k] = cross(q.normalWeights[k], h, q.dofs[k]);
+		M[k] = cross(q.normalWeights[k], e, q.dofs[k]);
+	}
+
+	const auto& freqs{ p.getFrequencies() };
+	auto& vectors{ p.getRadiationVectors() };
+	for (std::size_t f{ 0 }; f < freqs.size(); f++) {
+		const auto rotation{ std::polar(weight, -2.0 * M_PI * freqs[f] * time) };
+		for (std::size_t d{ 0 }; d < vectors[f].size(); d++) {
+			const auto& phases{ it->second.phases[f][d] };
+			ComplexVector3 N{}, L{};
+			for (std::size_t k{ 0 }; k < q.size(); k++) {
+				for (int c = 0; c < 3; c++) {
+					N[c] += J[k][c] * phases[k];
+					L[c] += M[k][c] * phases[k];
+				}
+			}
+			auto& v{ vectors[f][d] };
+			for (int c = 0; c < 3; c++) {
+				v.N[c] += rotation * N[c];
+				v.L[c] -= rotation * L[c];
+			}
+		}
+	}
+}
+
+void ProbesManager::updateTransforms(double time)
+{
+	// Right rectangle rule: each sample is weighted with the elapsed time.
+	const auto weight{ time - lastTransformTime_ };
+	lastTransformTime_ = time;
+	if (weight <= 0.0) {
+		return;
+	}
+	fields_.updateViews();
+	for (auto& p : probes_.dftProbes) {
+		updateProbe(p, time, weight);
+	}
+	for (auto& p : probes_.fieldDFTProbes) {
+		updateProbe(p, fields_, time, weight);
+	}
+	for (auto& p : probes_.nearToFarFieldProbes) {
+		updateProbe(p, time, weight);
+	}
+}
+
+void ProbesManager::sampleProbes(double time)
+{
+	fields_.updateViews();
+	for (auto& p: probes_.exporterProbes) {
+		updateProbe(p, time);
+	}
+	for (auto& p : probes_.xdmfExporterProbes) {
+		updateProbe(p, time);
+	}
+	for (auto& p : probes_.pointsProbes) {
+		updateProbe(p, time);
+	}
+	for (auto& p : probes_.gridProbes) {
+		updateProbe(p, time);
+	}
+	for (auto& p : probes_.energyProbes) {
+		updateProbe(p, time);
+	}
+	for (auto& p : probes_.poyntingFluxProbes) {
+		updateProbe(p, time);
+	}
+}
+
 void ProbesManager::updateProbes(double time)
 {
 	if (cycle_ % probes_.visSteps == 0) {
-		for (auto& p: probes_.exporterProbes) {
-			updateProbe(p, time);
+		sampleProbes(time);
+	}
+	cycle_++;
+}
+
+Time ProbesManager::getNextSampleTime() const
+{
+	auto res{ std::numeric_limits<Time>::infinity() };
+	const auto& period{ probes_.samplingSchedule.period };
+	if (period > 0.0) {
+		res = periodicSamples_ * period;
+	}
+	if (nextScheduledTime_ < scheduledTimes_.size()) {
+		res = std::min(res, scheduledTimes_[nextScheduledTime_]);
+	}
+	return res;
+}
+
+void ProbesManager::updateProbesAtScheduledTime(double time)
+{
+	sampleProbes(time);
+
+	const auto& period{ probes_.samplingSchedule.period };
+	const auto tol{ 1e-12 * std::max(1.0, std::abs(time)) };
+	while (period > 0.0 && periodicSamples_ * period <= time + tol) {
+		periodicSamples_++;
+	}
+	while (nextScheduledTime_ < scheduledTimes_.size() && scheduledTimes_[nextScheduledTime_] <= time + tol) {
+		nextScheduledTime_++;
+	}
+	cycle_++;
+}
+
+void write(BinaryWriter& w, const FieldMovie& movie)
+{
+	w.write<std::uint64_t>(movie.size());
+	for (const auto& frame : movie) {
+		w.write(frame.first);
+		w.write(frame.second);
+	}
+}
+
+template <class P>
+void readFieldMovie(BinaryReader& r, P& p)
+{
+	const auto n{ r.read<std::uint64_t>() };
+	for (std::uint64_t i{ 0 }; i < n; i++) {
+		const auto time{ r.read<Time>() };
+		p.addFrame(time, r.readVector());
+	}
+}
+
+void write(BinaryWriter& w, const std::vector<std::complex<double>>& v)
+{
+	w.write<std::uint64_t>(v.size());
+	w.write(v.data(), v.size() * sizeof(std::complex<double>));
+}
+
+void read(BinaryReader& r, std::vector<std::complex<double>>& v)
+{
+	if (r.read<std::uint64_t>() != v.size()) {
+		throw std::runtime_error("Stored transform size does not match.");
+	}
+	r.read(v.data(), v.size() * sizeof(std::complex<double>));
+}
+
+template <class T>
+void checkStoredSize(BinaryReader& r, const std::vector<T>& v)
+{
+	if (r.read<std::uint64_t>() != v.size()) {
+		throw std::runtime_error("Stored probes do not match the current ones.");
+	}
+}
+
+void ProbesManager::saveState(BinaryWriter& w) const
+{
+	w.write<std::int64_t>(cycle_);
+	w.write<std::int64_t>(periodicSamples_);
+	w.write<std::uint64_t>(nextScheduledTime_);
+	w.write(lastTransformTime_);
+
+	w.write<std::uint64_t>(probes_.pointsProbes.size());
+	for (const auto& p : probes_.pointsProbes) {
+		write(w, p.getFieldMovie());
+	}
+
+	w.write<std::uint64_t>(probes_.gridProbes.size());
+	for (const auto& p : probes_.gridProbes) {
+		const auto& out{ gridProbesCollection_.at(&p).out };
+		w.write<std::int64_t>(out && out->is_open() ? (std::int64_t) out->tellp() : 0);
+		write(w, p.getFieldMovie());
+	}
+
+	w.write<std::uint64_t>(probes_.dftProbes.size());
+	for (const auto& p : probes_.dftProbes) {
+		for (const auto& pointTransform : p.getTransform()) {
+			write(w, pointTransform);
+		}
+	}
+
+	w.write<std::uint64_t>(probes_.fieldDFTProbes.size());
+	for (const auto& p : probes_.fieldDFTProbes) {
+		for (std::size_t f{ 0 }; f < p.getFrequencies().size(); f++) {
+			w.write(p.getReal()[f]);
+			w.write(p.getImag()[f]);
 		}
-		for (auto& p : probes_.pointsProbes) {
-			updateProbe(p, time);
+	}
+
+	w.write<std::uint64_t>(probes_.energyProbes.size());
+	for (const auto& p : probes_.energyProbes) {
+		w.write<std::uint64_t>(p.getEnergyMovie().size());
+		for (const auto& frame : p.getEnergyMovie()) {
+			w.write(frame.first);
+			w.write(frame.second);
 		}
 	}
-	cycle_++;
+
+	w.write<std::uint64_t>(probes_.poyntingFluxProbes.size());
+	for (const auto& p : probes_.poyntingFluxProbes) {
+		w.write<std::uint64_t>(p.getFluxMovie().size());
+		for (const auto& frame : p.getFluxMovie()) {
+			w.write(frame.first);
+			w.write(frame.second);
+		}
+	}
+
+	w.write<std::uint64_t>(probes_.nearToFarFieldProbes.size());
+	for (const auto& p : probes_.nearToFarFieldProbes) {
+		for (const auto& vs : p.getRadiationVectors()) {
+			w.write(vs.data(), vs.size() * sizeof(RadiationVectors));
+		}
+	}
+}
+
+void ProbesManager::loadState(BinaryReader& r)
+{
+	cycle_ = (int) r.read<std::int64_t>();
+	periodicSamples_ = (int) r.read<std::int64_t>();
+	nextScheduledTime_ = (std::size_t) r.read<std::uint64_t>();
+	lastTransformTime_ = r.read<double>();
+
+	checkStoredSize(r, probes_.pointsProbes);
+	for (auto& p : probes_.pointsProbes) {
+		readFieldMovie(r, p);
+	}
+
+	checkStoredSize(r, probes_.gridProbes);
+	for (auto& p : probes_.gridProbes) {
+		auto& out{ gridProbesCollection_.at(&p).out };
+		const auto offset{ r.read<std::int64_t>() };
+		if (out) {
+			// Frames written after the checkpoint are discarded.
+			out->close();
+			if (offset > 0) {
+				truncateFile(p.getName() + ".bin", (std::size_t) offset);
+				openGridProbeFile(p, *out, std::ios::app);
+			}
+		}
+		readFieldMovie(r, p);
+	}
+
+	checkStoredSize(r, probes_.dftProbes);
+	for (auto& p : probes_.dftProbes) {
+		for (auto& pointTransform : p.getTransform()) {
+			read(r, pointTransform);
+		}
+	}
+
+	checkStoredSize(r, probes_.fieldDFTProbes);
+	for (auto& p : probes_.fieldDFTProbes) {
+		for (std::size_t f{ 0 }; f < p.getFrequencies().size(); f++) {
+			r.read(p.getReal()[f]);
+			r.read(p.getImag()[f]);
+		}
+	}
+
+	checkStoredSize(r, probes_.energyProbes);
+	for (auto& p : probes_.energyProbes) {
+		const auto n{ r.read<std::uint64_t>() };
+		for (std::uint64_t i{ 0 }; i < n; i++) {
+			const auto time{ r.read<Time>() };
+			p.addFrame(time, r.read<Energy>());
+		}
+	}
+
+	checkStoredSize(r, probes_.poyntingFluxProbes);
+	for (auto& p : probes_.poyntingFluxProbes) {
+		const auto n{ r.read<std::uint64_t>() };
+		for (std::uint64_t i{ 0 }; i < n; i++) {
+			const auto time{ r.read<Time>() };
+			p.addFrame(time, r.read<double>());
+		}
+	}
+
+	checkStoredSize(r, probes_.nearToFarFieldProbes);
+	for (auto& p : probes_.nearToFarFieldProbes) {
+		for (auto& vs : p.getRadiationVectors()) {
+			r.read(vs.data(), vs.size() * sizeof(RadiationVectors));
+		}
+	}
+}
+
 }
-}
\ No newline at end of file
@@ -2,13 +2,19 @@
 
 #include "Probes.h"
 #include "Fields.h"
+#include "Model.h"
+#include "SurfaceQuadrature.h"
+#include "XDMFExporter.h"
+#include "PointLocator.h"
+#include "Checkpoint.h"
 
 namespace maxwell {
 
 class ProbesManager {
 public:
     ProbesManager() = delete;
-    ProbesManager(Probes, const mfem::FiniteElementSpace&, Fields&);
+    // Integral probes use the materials, vacuum is assumed when none are given.
+    ProbesManager(Probes, const mfem::FiniteElementSpace&, Fields&, const AttributeToMaterial& = AttributeToMaterial{});
     
     ProbesManager(const ProbesManager&) = delete;
     ProbesManager(ProbesManager&&) = default;
@@ -18,32 +24,89 @@ public:
 
     void updateProbes(double time);
 
+    bool isTimeSampled() const { return probes_.samplingSchedule.isTimeBased(); }
+    Time getNextSampleTime() const;
+    void updateProbesAtScheduledTime(double time);
+
+    void updateTransforms(double time);
+
+    // Sampling state, probe movies and transforms, as stored in checkpoints.
+    void saveState(BinaryWriter&) const;
+    void loadState(BinaryReader&);
+
     const PointsProbe& getPointsProbe(const std::size_t i) const;
+    const GridProbe& getGridProbe(const std::size_t i) const;
+    const DFTProbe& getDFTProbe(const std::size_t i) const;
+    const FieldDFTProbe& getFieldDFTProbe(const std::size_t i) const;
+    const EnergyProbe& getEnergyProbe(const std::size_t i) const;
+    const PoyntingFluxProbe& getPoyntingFluxProbe(const std::size_t i) const;
+    const NearToFarFieldProbe& getNearToFarFieldProbe(const std::size_t i) const;
 
 private:
-    struct FESPoint {
-        int elementId;
-        mfem::IntegrationPoint iP;
+    using Locations = std::vector<PointLocator::Location>;
+
+    struct GridProbeCollection {
+        std::unique_ptr<mfem::SparseMatrix> interpolator;
+        const mfem::GridFunction& field;
+        std::unique_ptr<std::ofstream> out;
     };
 
     struct PointsProbeCollection {
-        std::vector<FESPoint> fesPoints;
+        std::unique_ptr<mfem::SparseMatrix> interpolator;
         const mfem::GridFunction& field;
     };
 
+    struct EnergyProbeCollection {
+        std::unique_ptr<mfem::SparseMatrix> electricMass, magneticMass;
+    };
+
+    struct NearToFarFieldProbeCollection {
+        SurfaceQuadrature quadrature;
+        // exp(j omega rHat . r') of each node, indexed as [frequency][direction][node].
+        std::vector<std::vector<std::vector<std::complex<double>>>> phases;
+    };
+
     int cycle_{ 0 };
+    int periodicSamples_{ 0 };
+    std::vector<Time> scheduledTimes_;
+    std::size_t nextScheduledTime_{ 0 };
+    double lastTransformTime_{ 0.0 };
 
     Probes probes_;
     std::map<const ExporterProbe*, mfem::ParaViewDataCollection> exporterProbesCollection_;
+    std::map<const XDMFExporterProbe*, XDMFExporter> xdmfExporterProbesCollection_;
     std::map<const PointsProbe*, PointsProbeCollection> pointProbesCollection_;
+    std::map<const DFTProbe*, PointsProbeCollection> dftProbesCollection_;
+    std::map<const GridProbe*, GridProbeCollection> gridProbesCollection_;
+    std::map<const EnergyProbe*, EnergyProbeCollection> energyProbesCollection_;
+    std::map<const PoyntingFluxProbe*, SurfaceQuadrature> poyntingFluxProbesCollection_;
+    std::map<const NearToFarFieldProbe*, NearToFarFieldProbeCollection> nearToFarFieldProbesCollection_;
+    mfem::Vector pointValues_;
     
     const mfem::FiniteElementSpace& fes_;
+    mutable std::unique_ptr<PointLocator> pointLocator_;
     
     mfem::ParaViewDataCollection buildParaviewDataCollection(const ExporterProbe&, Fields&) const;
-    PointsProbeCollection buildPointsProbeCollection(const PointsProbe&, Fields&) const;
+    const PointLocator& getPointLocator() const;
+    std::unique_ptr<mfem::SparseMatrix> buildInterpolator(const Locations&) const;
+    template <class P>
+    PointsProbeCollection buildPointsProbeCollection(const P&, const Locations&, Fields&) const;
+    GridProbeCollection buildGridProbeCollection(const GridProbe&, const Locations&, Fields&) const;
+    EnergyProbeCollection buildEnergyProbeCollection(const EnergyProbe&, const AttributeToMaterial&) const;
+    NearToFarFieldProbeCollection buildNearToFarFieldProbeCollection(const NearToFarFieldProbe&) const;
     
+    void sampleProbes(double time);
     void updateProbe(ExporterProbe&, double time);
+    void updateProbe(XDMFExporterProbe&, double time);
     void updateProbe(PointsProbe&, double time);
+    void updateProbe(GridProbe&, double time);
+    void updateProbe(EnergyProbe&, double time);
+    void updateProbe(PoyntingFluxProbe&, double time);
+    void updateProbe(DFTProbe&, double time, double weight);
+    void updateProbe(FieldDFTProbe&, Fields&, double time, double weight);
+    void updateProbe(NearToFarFieldProbe&, double time, double weight);
+
+    Fields& fields_;
 };
 
 }
\ No newline at end of file
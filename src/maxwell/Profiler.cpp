@@ -0,0 +1,163 @@
+#include "Profiler.h"
+
+#include <iomanip>
+#include <sstream>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#elif defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace maxwell {
+
+std::string getRegionName(const ProfiledRegion& r)
+{
+	switch (r) {
+	case ProfiledRegion::Assembly:
+		return "assembly";
+	case ProfiledRegion::Mult:
+		return "mult";
+	case ProfiledRegion::RKUpdate:
+		return "rkUpdate";
+	case ProfiledRegion::Probes:
+		return "probes";
+	case ProfiledRegion::Export:
+		return "export";
+	case ProfiledRegion::Checkpoint:
+		return "checkpoint";
+	case ProfiledRegion::MS:
+		return "MS";
+	case ProfiledRegion::MFN:
+		return "MFN";
+	case ProfiledRegion::MFNN:
+		return "MFNN";
+	case ProfiledRegion::MP:
+		return "MP";
+	default:
+		return "otherOperators";
+	}
+}
+
+ProfiledRegion getRegion(const OperatorGroup& g)
+{
+	switch (g) {
+	case OperatorGroup::MS:
+		return ProfiledRegion::MS;
+	case OperatorGroup::MFN:
+		return ProfiledRegion::MFN;
+	case OperatorGroup::MFNN:
+		return ProfiledRegion::MFNN;
+	case OperatorGroup::MP:
+		return ProfiledRegion::MP;
+	default:
+		return ProfiledRegion::OtherOperators;
+	}
+}
+
+static thread_local Profiler* currentProfiler{ nullptr };
+
+Profiler& Profiler::global()
+{
+	static Profiler res;
+	return res;
+}
+
+Profiler& Profiler::current()
+{
+	return currentProfiler ? *currentProfiler : global();
+}
+
+ProfilerScope::ProfilerScope(Profiler& profiler) :
+	previous_{ currentProfiler }
+{
+	currentProfiler = &profiler;
+}
+
+ProfilerScope::~ProfilerScope()
+{
+	currentProfiler = previous_;
+}
+
+void Profiler::reset()
+{
+	counters_.fill(ProfileCounter{});
+	start_ = std::chrono::steady_clock::now();
+}
+
+void Profiler::add(const ProfiledRegion& r, double seconds, double dofs, double bytes)
+{
+	auto& counter{ counters_[(std::size_t) r] };
+	counter.seconds += seconds;
+	counter.calls++;
+	counter.dofs += dofs;
+	counter.bytes += bytes;
+}
+
+double Profiler::getOperatorBytes() const
+{
+	double res{ 0.0 };
+	for (auto r : { ProfiledRegion::MS, ProfiledRegion::MFN, ProfiledRegion::MFNN, ProfiledRegion::MP, ProfiledRegion::OtherOperators }) {
+		res += counters_[(std::size_t) r].bytes;
+	}
+	return res;
+}
+
+PerformanceReport Profiler::buildReport() const
+{
+	PerformanceReport res;
+	res.regions = counters_;
+	res.wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+	res.peakMemory = getPeakMemory();
+	return res;
+}
+
+std::string PerformanceReport::toJSON() const
+{
+	auto perSecond = [](double v, double seconds) { return seconds > 0.0 ? v / seconds : 0.0; };
+
+	std::stringstream ss;
+	ss << std::setprecision(17);
+	ss << "{\n";
+	ss << "  \"wallTime\": " << wallTime << ",\n";
+	ss << "  \"peakMemoryBytes\": " << peakMemory << ",\n";
+	ss << "  \"regions\": {\n";
+	for (std::size_t r{ 0 }; r < regions.size(); r++) {
+		const auto& c{ regions[r] };
+		ss << "    \"" << getRegionName((ProfiledRegion) r) << "\": { "
+			<< "\"seconds\": " << c.seconds << ", "
+			<< "\"calls\": " << c.calls << ", "
+			<< "\"dofs\": " << c.dofs << ", "
+			<< "\"dofsPerSecond\": " << perSecond(c.dofs, c.seconds) << ", "
+			<< "\"bytes\": " << c.bytes << ", "
+			<< "\"bytesPerSecond\": " << perSecond(c.bytes, c.seconds) << " }"
+			<< (r + 1 < regions.size() ? ",\n" : "\n");
+	}
+	ss << "  }\n";
+	ss << "}\n";
+	return ss.str();
+}
+
+std::size_t getPeakMemory()
+{
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+		return counters.PeakWorkingSetSize;
+	}
+	return 0;
+#elif defined(__APPLE__)
+	struct rusage usage;
+	return getrusage(RUSAGE_SELF, &usage) == 0 ? (std::size_t) usage.ru_maxrss : 0;
+#elif defined(__unix__)
+	// Linux reports kilobytes.
+	struct rusage usage;
+	return getrusage(RUSAGE_SELF, &usage) == 0 ? (std::size_t) usage.ru_maxrss * 1024 : 0;
+#else
+	return 0;
+#endif
+}
+
+}
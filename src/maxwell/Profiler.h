@@ -0,0 +1,130 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace maxwell {
+
+// Operators of the evolutions, as named in their members.
+enum class OperatorGroup {
+	MS,
+	MFN,
+	MFNN,
+	MP,
+	Other
+};
+
+/** Regions timed by the profiler. Regions nest: operator groups are timed
+	inside Mult, Mult and RKUpdate inside the time steps and Export inside
+	Probes, so the times of nested regions must not be added to their
+	parents.
+	*/
+enum class ProfiledRegion {
+	Assembly,
+	Mult,
+	RKUpdate,
+	Probes,
+	Export,
+	Checkpoint,
+	MS,
+	MFN,
+	MFNN,
+	MP,
+	OtherOperators
+};
+
+const std::size_t numberOfProfiledRegions{ 11 };
+
+std::string getRegionName(const ProfiledRegion&);
+ProfiledRegion getRegion(const OperatorGroup&);
+
+struct ProfileCounter {
+	double seconds{ 0.0 };
+	std::size_t calls{ 0 };
+	// DoFs updated and estimated bytes read and written, summed over all calls.
+	double dofs{ 0.0 };
+	double bytes{ 0.0 };
+};
+
+struct PerformanceReport {
+	std::array<ProfileCounter, numberOfProfiledRegions> regions;
+	// Since the last reset of the profiler.
+	double wallTime{ 0.0 };
+	// Peak resident set size of the process, zero when not available.
+	std::size_t peakMemory{ 0 };
+
+	const ProfileCounter& get(const ProfiledRegion& r) const { return regions[(std::size_t) r]; }
+	std::string toJSON() const;
+};
+
+/** Accumulates the time spent in each region.
+	Timers add to the current profiler of their thread, the one of the
+	innermost ProfilerScope or the global one outside of any. Solvers own a
+	profiler and make it current while they work, so solvers living at the
+	same time keep separate counters.
+	Counters are only updated from the thread driving the solver, outside
+	of the OpenMP parallel regions, and cost two clock reads per call.
+	*/
+class Profiler {
+public:
+	static Profiler& global();
+	static Profiler& current();
+
+	void reset();
+	void add(const ProfiledRegion&, double seconds, double dofs, double bytes);
+	PerformanceReport buildReport() const;
+	// Bytes estimated by all the operator groups.
+	double getOperatorBytes() const;
+
+private:
+	std::array<ProfileCounter, numberOfProfiledRegions> counters_;
+	std::chrono::steady_clock::time_point start_{ std::chrono::steady_clock::now() };
+};
+
+// Makes a profiler the current one of this thread until its destruction.
+class ProfilerScope {
+public:
+	explicit ProfilerScope(Profiler&);
+	~ProfilerScope();
+	ProfilerScope(const ProfilerScope&) = delete;
+	ProfilerScope& operator=(const ProfilerScope&) = delete;
+
+private:
+	Profiler* previous_;
+};
+
+// Adds the time until its destruction to a region of the profiler current at its construction.
+class ScopedTimer {
+public:
+	ScopedTimer(const ProfiledRegion& region, double dofs = 0.0, double bytes = 0.0) :
+		profiler_{ Profiler::current() },
+		region_{ region },
+		dofs_{ dofs },
+		bytes_{ bytes },
+		start_{ std::chrono::steady_clock::now() }
+	{}
+	ScopedTimer(const ScopedTimer&) = delete;
+	ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+	~ScopedTimer()
+	{
+		const std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start_ };
+		profiler_.add(region_, elapsed.count(), dofs_, bytes_);
+	}
+
+	// For regions whose traffic is only known once they run.
+	void addBytes(double bytes) { bytes_ += bytes; }
+
+private:
+	Profiler& profiler_;
+	ProfiledRegion region_;
+	double dofs_, bytes_;
+	std::chrono::steady_clock::time_point start_;
+};
+
+// Peak resident set size of the process in bytes, zero when not available.
+std::size_t getPeakMemory();
+
+}
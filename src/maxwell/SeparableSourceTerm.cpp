@@ -0,0 +1,61 @@
+#include "SeparableSourceTerm.h"
+#include "SourcesManager.h"
+
+#include <cmath>
+
+namespace maxwell {
+
+using namespace mfem;
+
+// Profile values under this fraction of the maximum are out of the support.
+static const double supportTolerance{ 1e-12 };
+
+SeparableSourceTerm::SeparableSourceTerm(
+	FiniteElementSpace& fes,
+	const Model& model,
+	const SeparableSource& source,
+	const StateLayout& layout) :
+	waveform_{ source.getWaveform().clone() }
+{
+	GridFunction projected{ &fes };
+	projected = 0.0;
+	source.getProfile().addValues(buildNodalPositions(fes), projected);
+
+	const auto component{ getComponent(fes.GetMesh()->Dimension(), source.fieldType, source.direction) };
+	const auto threshold{ supportTolerance * projected.Normlinf() };
+	const auto& materials{ model.getAttributeToMaterial() };
+	std::vector<double> values;
+	Array<int> elemDofs;
+	for (int e = 0; e < fes.GetNE(); e++) {
+		double coefficient{ 1.0 };
+		const auto it{ materials.find(fes.GetMesh()->GetAttribute(e)) };
+		if (it != materials.end()) {
+			coefficient = source.fieldType == E ? it->second.getPermittivity() : it->second.getPermeability();
+		}
+		fes.GetElementDofs(e, elemDofs);
+		for (const auto& dof : elemDofs) {
+			if (std::abs(projected[dof]) <= threshold) {
+				continue;
+			}
+			dofs_.Append(layout.index(component, dof));
+			values.push_back(-projected[dof] / coefficient);
+		}
+	}
+	values_.SetSize((int) values.size());
+	for (int i = 0; i < values_.Size(); i++) {
+		values_[i] = values[i];
+	}
+}
+
+void SeparableSourceTerm::addTerms(const Time& time, Vector& out) const
+{
+	const auto g{ waveform_->eval(time) };
+	if (g == 0.0) {
+		return;
+	}
+	for (int i = 0; i < dofs_.Size(); i++) {
+		out[dofs_[i]] += g * values_[i];
+	}
+}
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <mfem.hpp>
+
+#include "Model.h"
+#include "Sources.h"
+#include "SourceTerm.h"
+
+namespace maxwell {
+
+/** Evolution term of a separable source.
+	The profile is projected once onto the finite element space, divided by
+	the material coefficient of its element and kept only on its support,
+	so each stage adds a single scaled sparse vector to the derivative of
+	the source field component, wherever the layout stores it.
+	*/
+class SeparableSourceTerm : public SourceTerm {
+public:
+	SeparableSourceTerm(mfem::FiniteElementSpace&, const Model&, const SeparableSource&, const StateLayout&);
+
+	void addTerms(const Time&, mfem::Vector& out) const;
+
+private:
+	std::unique_ptr<Waveform> waveform_;
+
+	mfem::Array<int> dofs_;
+	mfem::Vector values_;
+};
+
+}
@@ -3,6 +3,7 @@
 #include <algorithm>
 
 #include "Solver.h"
+#include "Hashing.h"
 
 using namespace mfem;
 
@@ -19,31 +20,55 @@ Solver::Solver(
 	const SolverOptions& options) :
 	opts_{ options },
 	model_{ model },
+	orderingReport_{ reorderElements(model_.getMesh(), opts_.elementOrdering) },
 	fec_{ opts_.order, model_.getMesh().Dimension(), BasisType::GaussLobatto},
 	fes_{ &model_.getMesh(), &fec_ },
-	fields_{ fes_ },
+	fields_{ fes_, opts_.evolutionOperatorOptions.fieldsLayout, opts_.evolutionOperatorOptions.memoryPlacement },
 	sourcesManager_{ sources, fes_ },
-	probesManager_{ probes, fes_, fields_},
+	hardSources_{ fes_, model_, sourcesManager_.sources, PointSourceType::Hard, fields_.getLayout() },
+	probesManager_{ probes, fes_, fields_, model_.getAttributeToMaterial() },
 	time_{0.0}
 {
+	ProfilerScope profiling{ profiler_ };
+	assembleEvolution();
+	fields_.updateDOFs();
+	if (maxwellEvol_->Width() != fields_.allDOFs.Size()) {
+		fields_.setNumberOfAuxiliaryDOFs(maxwellEvol_->Width() - fields_.getNumberOfFieldDOFs());
+	}
+	maxwellEvol_->SetTime(time_);
+	odeSolver_->Init(*maxwellEvol_);
+
+	if (opts_.restartFrom.empty()) {
+		hardSources_.imposeHardSources(time_, fields_.allDOFs);
+		updateProbes();
+	}
+	else {
+		loadCheckpoint(opts_.restartFrom);
+	}
+
+	nextCheckpointTime_ = time_ + opts_.checkpoint.period;
+	if (!opts_.checkpoint.filename.empty() && opts_.checkpoint.onSignal) {
+		signalHandlers_ = std::make_unique<CheckpointSignalHandlers>();
+	}
+}
+
+void Solver::assembleEvolution()
+{
+	ScopedTimer timer{ ProfiledRegion::Assembly, (double) fields_.getNumberOfFieldDOFs() };
 	switch (fes_.GetMesh()->Dimension()) {
 	case 1:
 		sourcesManager_.setFields1D(fields_);
-		maxwellEvol_ = std::make_unique<MaxwellEvolution1D>(fes_, model_, opts_.evolutionOperatorOptions);
+		maxwellEvol_ = std::make_unique<MaxwellEvolution1D>(fes_, model_, opts_.evolutionOperatorOptions, sourcesManager_.sources);
 		break;
 	case 2:
 		sourcesManager_.setFields3D(fields_);
-		maxwellEvol_ = std::make_unique<MaxwellEvolution2D>(fes_, model_, opts_.evolutionOperatorOptions);
+		maxwellEvol_ = std::make_unique<MaxwellEvolution2D>(fes_, model_, opts_.evolutionOperatorOptions, sourcesManager_.sources);
 		break;
 	default:
 		sourcesManager_.setFields3D(fields_);
-		maxwellEvol_ = std::make_unique<MaxwellEvolution3D>(fes_, model_, opts_.evolutionOperatorOptions);
+		maxwellEvol_ = std::make_unique<MaxwellEvolution3D>(fes_, model_, opts_.evolutionOperatorOptions, sourcesManager_.sources);
 		break;
 	}
-	maxwellEvol_->SetTime(time_);
-	odeSolver_->Init(*maxwellEvol_);
-
-	probesManager_.updateProbes(time_);
 }
 
 void Solver::checkOptionsAreValid(const SolverOptions& opts)
@@ -60,6 +85,41 @@ const PointsProbe& Solver::getPointsProbe(const std::size_t probe) const
 	return probesManager_.getPointsProbe(probe); 
 }
 
+const GridProbe& Solver::getGridProbe(const std::size_t probe) const
+{
+	return probesManager_.getGridProbe(probe);
+}
+
+const DFTProbe& Solver::getDFTProbe(const std::size_t probe) const
+{
+	return probesManager_.getDFTProbe(probe);
+}
+
+const FieldDFTProbe& Solver::getFieldDFTProbe(const std::size_t probe) const
+{
+	return probesManager_.getFieldDFTProbe(probe);
+}
+
+const EnergyProbe& Solver::getEnergyProbe(const std::size_t probe) const
+{
+	return probesManager_.getEnergyProbe(probe);
+}
+
+const PoyntingFluxProbe& Solver::getPoyntingFluxProbe(const std::size_t probe) const
+{
+	return probesManager_.getPoyntingFluxProbe(probe);
+}
+
+const NearToFarFieldProbe& Solver::getNearToFarFieldProbe(const std::size_t probe) const
+{
+	return probesManager_.getNearToFarFieldProbe(probe);
+}
+
+PagePlacementReport Solver::getStatePagePlacement() const
+{
+	return getPagePlacement(fields_.allDOFs.GetData(), fields_.allDOFs.Size() * sizeof(double));
+}
+
 //const double Solver::calculateTimeStep() const
 //{
 //	
@@ -67,9 +127,118 @@ const PointsProbe& Solver::getPointsProbe(const std::size_t probe) const
 
 void Solver::run()
 {
+	ProfilerScope profiling{ profiler_ };
 	while ( std::abs(time_ - opts_.t_final) < 1e-6 || time_ < opts_.t_final) {
 		odeSolver_->Step(fields_.allDOFs, time_, opts_.dt);
+		hardSources_.imposeHardSources(time_, fields_.allDOFs);
+		updateProbes();
+		if (!checkpointIfNeeded()) {
+			break;
+		}
+	}
+	fields_.updateViews();
+
+	if (!opts_.performanceReport.empty()) {
+		std::ofstream out{ opts_.performanceReport, std::ios::trunc };
+		if (!out) {
+			throw std::runtime_error("Could not open performance report " + opts_.performanceReport);
+		}
+		out << getPerformanceReport().toJSON();
+	}
+}
+
+PerformanceReport Solver::getPerformanceReport() const
+{
+	return profiler_.buildReport();
+}
+
+std::uint64_t Solver::buildConfigurationHash() const
+{
+	Hasher h;
+	h.add(model_);
+	h.add(opts_.order);
+	h.add(opts_.evolutionOperatorOptions.fluxType);
+	h.add(opts_.evolutionOperatorOptions.fieldsLayout);
+	h.add(fields_.allDOFs.Size());
+	return h.value();
+}
+
+void Solver::saveCheckpoint(const std::string& filename) const
+{
+	ProfilerScope profiling{ profiler_ };
+	ScopedTimer timer{ ProfiledRegion::Checkpoint, (double) fields_.allDOFs.Size(), (double) (fields_.allDOFs.Size() * sizeof(double)) };
+	// The stages of the integrator are not needed, each step only depends
+	// on the fields at its beginning.
+	BinaryWriter w;
+	writeCheckpointHeader(w, buildConfigurationHash());
+	w.write(time_);
+	w.write(fields_.allDOFs);
+	probesManager_.saveState(w);
+	saveToFile(w, filename);
+}
+
+void Solver::loadCheckpoint(const std::string& filename)
+{
+	MappedFile file{ filename };
+	auto r{ openCheckpoint(file, buildConfigurationHash()) };
+	time_ = r.read<double>();
+	r.read(fields_.allDOFs);
+	probesManager_.loadState(r);
+	fields_.updateViews();
+
+	maxwellEvol_->SetTime(time_);
+	odeSolver_->Init(*maxwellEvol_);
+}
+
+bool Solver::checkpointIfNeeded()
+{
+	const auto& opts{ opts_.checkpoint };
+	if (opts.filename.empty()) {
+		return true;
+	}
+
+	auto request{ opts.onSignal ? takeCheckpointRequest() : CheckpointRequest::None };
+	if (opts.period > 0.0 && time_ >= nextCheckpointTime_ - 1e-9 * opts_.dt) {
+		while (nextCheckpointTime_ <= time_ + 1e-9 * opts_.dt) {
+			nextCheckpointTime_ += opts.period;
+		}
+		if (request == CheckpointRequest::None) {
+			request = CheckpointRequest::Checkpoint;
+		}
+	}
+
+	if (request != CheckpointRequest::None) {
+		saveCheckpoint(opts.filename);
+	}
+	return request != CheckpointRequest::CheckpointAndStop;
+}
+
+void Solver::updateProbes()
+{
+	ScopedTimer timer{ ProfiledRegion::Probes };
+	probesManager_.updateTransforms(time_);
+
+	if (!probesManager_.isTimeSampled()) {
 		probesManager_.updateProbes(time_);
+		return;
+	}
+
+	// Samples inside the last step are evaluated with the dense output of 
+	// the integrator, so sampling times do not depend on dt.
+	const auto tol{ 1e-9 * opts_.dt };
+	while (probesManager_.getNextSampleTime() <= time_ + tol) {
+		const auto t{ probesManager_.getNextSampleTime() };
+		if (odeSolver_->hasStep() && t < time_ - tol) {
+			stateBuffer_ = fields_.allDOFs;
+			odeSolver_->interpolate(t, fields_.allDOFs);
+			// Hard sources force their DoFs at every sample, as after each step.
+			hardSources_.imposeHardSources(t, fields_.allDOFs);
+			probesManager_.updateProbesAtScheduledTime(t);
+			fields_.allDOFs = stateBuffer_;
+		}
+		else {
+			probesManager_.updateProbesAtScheduledTime(t);
+		}
 	}
 }
 
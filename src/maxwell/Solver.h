@@ -5,6 +5,11 @@
 #include "ProbesManager.h"
 #include "SourcesManager.h"
 #include "SolverOptions.h"
+#include "DenseRK4Solver.h"
+#include "Checkpoint.h"
+#include "ElementOrdering.h"
+#include "MemoryPlacement.h"
+#include "Profiler.h"
 #include "MaxwellEvolution3D.h"
 #include "MaxwellEvolution2D.h"
 #include "MaxwellEvolution1D.h"
@@ -31,27 +36,58 @@ public:
 
     const Fields& getFields() const { return fields_; };
     const PointsProbe& getPointsProbe(const std::size_t probe) const;
+    const GridProbe& getGridProbe(const std::size_t probe) const;
+    const DFTProbe& getDFTProbe(const std::size_t probe) const;
+    const FieldDFTProbe& getFieldDFTProbe(const std::size_t probe) const;
+    const EnergyProbe& getEnergyProbe(const std::size_t probe) const;
+    const PoyntingFluxProbe& getPoyntingFluxProbe(const std::size_t probe) const;
+    const NearToFarFieldProbe& getNearToFarFieldProbe(const std::size_t probe) const;
 
     const TimeDependentOperator* getFEEvol() const { return maxwellEvol_.get(); }
+    const ElementOrderingReport& getElementOrderingReport() const { return orderingReport_; }
+    double getTime() const { return time_; }
+    // NUMA nodes holding the pages of the state vector.
+    PagePlacementReport getStatePagePlacement() const;
+    // Time per phase and operator group since construction, see Profiler.h.
+    PerformanceReport getPerformanceReport() const;
 
     void run();
 
+    void saveCheckpoint(const std::string& filename) const;
+
 private:
     SolverOptions opts_;
+    // Current while the solver works, see Profiler.h.
+    mutable Profiler profiler_;
     Model model_;
+    ElementOrderingReport orderingReport_;
     mfem::DG_FECollection fec_;
     mfem::FiniteElementSpace fes_;
     Fields fields_;
     
     SourcesManager sourcesManager_;
+    PointDipoles hardSources_;
     ProbesManager probesManager_;
     
     double time_;
-    std::unique_ptr<ODESolver> odeSolver_{ std::make_unique<mfem::RK4Solver>() };
+    std::unique_ptr<DenseRK4Solver> odeSolver_{ 
+        std::make_unique<DenseRK4Solver>(fields_.getLayout(), opts_.evolutionOperatorOptions.memoryPlacement) 
+    };
+    Vector stateBuffer_;
     
     std::unique_ptr<mfem::TimeDependentOperator> maxwellEvol_;
 
+    double nextCheckpointTime_;
+    std::unique_ptr<CheckpointSignalHandlers> signalHandlers_;
+
+    void assembleEvolution();
     void checkOptionsAreValid(const SolverOptions&);
+    void updateProbes();
+
+    std::uint64_t buildConfigurationHash() const;
+    void loadCheckpoint(const std::string& filename);
+    // Returns false if the run must stop.
+    bool checkpointIfNeeded();
 
     const double Solver::calculateTimeStep() const;
 
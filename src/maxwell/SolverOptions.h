@@ -1,15 +1,32 @@
 #pragma once
 
+#include <string>
+
 #include "Types.h"
 
 namespace maxwell {
 
+struct CheckpointOptions {
+    // An empty filename disables checkpoints.
+    std::string filename;
+    // Non positive periods disable periodic checkpoints.
+    double period{ 0.0 };
+    // Checkpoints on SIGUSR1, and on SIGTERM before stopping the run.
+    bool onSignal{ false };
+};
+
 struct SolverOptions {
     int order = 2;
     double dt = 1e-3;
     double t_final = 2.0;
     double CFL = 0.9;
+    ElementOrdering elementOrdering{ ElementOrdering::None };
     MaxwellEvolOptions evolutionOperatorOptions;
+    CheckpointOptions checkpoint;
+    // Checkpoint file to resume the run from, if any.
+    std::string restartFrom;
+    // JSON file written by run with the time spent in each phase, if any.
+    std::string performanceReport;
     
     SolverOptions& setTimeStep(double t) {
         dt = t;
@@ -27,6 +44,30 @@ struct SolverOptions {
         CFL = cfl;
         return *this;
     }
+    SolverOptions& setCheckpoint(const std::string& filename, double period = 0.0, bool onSignal = false) {
+        checkpoint = { filename, period, onSignal };
+        return *this;
+    }
+    SolverOptions& setRestart(const std::string& filename) {
+        restartFrom = filename;
+        return *this;
+    }
+    SolverOptions& setPerformanceReport(const std::string& filename) {
+        performanceReport = filename;
+        return *this;
+    }
+    SolverOptions& setElementOrdering(const ElementOrdering& o) {
+        elementOrdering = o;
+        return *this;
+    }
+    SolverOptions& setFieldsLayout(const FieldsLayout& l) {
+        evolutionOperatorOptions.fieldsLayout = l;
+        return *this;
+    }
+    SolverOptions& setMemoryPlacement(bool firstTouch, bool hugePages = false) {
+        evolutionOperatorOptions.memoryPlacement = { firstTouch, hugePages };
+        return *this;
+    }
     SolverOptions& setOrder(int or) {
         order = or;
         return *this;
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <mfem.hpp>
+
+#include "Types.h"
+#include "StateLayout.h"
+
+namespace maxwell {
+
+/** Time dependent excitation of the evolution.
+	Spatial parts are precomputed when the term is built, so each stage only
+	adds the contribution at the given time to the field derivatives.
+	*/
+class SourceTerm {
+public:
+	virtual ~SourceTerm() = default;
+
+	virtual void addTerms(const Time&, mfem::Vector& out) const = 0;
+};
+
+using SourceTerms = std::vector<std::unique_ptr<SourceTerm>>;
+
+}
@@ -2,9 +2,31 @@
 
 #define _USE_MATH_DEFINES
 #include <math.h>
+#include <cmath>
 
 namespace maxwell {
 
+void Source::addValues(const NodalPositions& positions, mfem::Vector& res) const
+{
+	Position pos(positions.Width());
+	for (int i = 0; i < positions.Height(); i++) {
+		for (int d = 0; d < positions.Width(); d++) {
+			pos[d] = positions(i, d);
+		}
+		switch (positions.Width()) {
+		case 1:
+			res[i] += eval1D(pos);
+			break;
+		case 2:
+			res[i] += eval2D(pos);
+			break;
+		default:
+			res[i] += eval3D(pos);
+			break;
+		}
+	}
+}
+
 GaussianInitialField::GaussianInitialField(
 	const FieldType& ft,
 	const Direction& d,
@@ -48,6 +70,24 @@ double GaussianInitialField::eval1D(const Position& pos) const
 		* exp(-pow(pos[X] - center[X], 2) / (2.0 * pow(spread_, 2)));
 }
 
+void GaussianInitialField::addValues(const NodalPositions& positions, mfem::Vector& res) const
+{
+	const auto n{ positions.Height() };
+	const auto factor{ -1.0 / (2.0 * pow(spread_, 2.0)) };
+	std::vector<double> r2(n, 0.0);
+	for (int d = 0; d < positions.Width(); d++) {
+		const auto* x{ positions.GetColumn(d) };
+		const auto c{ center[d] };
+		for (int i = 0; i < n; i++) {
+			r2[i] += (x[i] - c) * (x[i] - c);
+		}
+	}
+	auto* v{ res.GetData() };
+	for (int i = 0; i < n; i++) {
+		v[i] += normalization_ * exp(factor * r2[i]);
+	}
+}
+
 SinusoidalInitialField::SinusoidalInitialField(
 	const FieldType& ft,
 	const Direction& d,
@@ -91,4 +131,112 @@ double SinusoidalInitialField::eval1D(const Position& pos) const
 {
 	return sin(coefficient_[X] * modes_[X] * M_PI * pos[X]);
 }
+
+void SinusoidalInitialField::addValues(const NodalPositions& positions, mfem::Vector& res) const
+{
+	// As in evalXD, 3D products skip the field direction.
+	std::vector<Direction> dirs;
+	switch (positions.Width()) {
+	case 1:
+		dirs = { X };
+		break;
+	case 2:
+		dirs = { X, Y };
+		break;
+	default:
+		dirs = { (direction + 1) % 3, (direction + 2) % 3 };
+		break;
+	}
+
+	const auto n{ positions.Height() };
+	std::vector<double> product(n, 1.0);
+	for (const auto& d : dirs) {
+		const auto* x{ positions.GetColumn(d) };
+		const auto k{ coefficient_[d] * modes_[d] * M_PI };
+		for (int i = 0; i < n; i++) {
+			product[i] *= sin(k * x[i]);
+		}
+	}
+	auto* v{ res.GetData() };
+	for (int i = 0; i < n; i++) {
+		v[i] += product[i];
+	}
+}
+
+Planewave::Planewave(
+	const Position& polarization,
+	const Position& propagation,
+	const Waveform& waveform,
+	const std::vector<Attribute>& bdrAttributes,
+	const Position cnt) :
+	polarization_(polarization),
+	propagation_(propagation),
+	waveform_(waveform.clone()),
+	attributes_(bdrAttributes)
+{
+	center = cnt;
+	if (polarization_.Size() != 3 || propagation_.Size() != 3 || center.Size() != 3) {
+		throw std::runtime_error("Planewave vectors must have three components.");
+	}
+	if (propagation_.Norml2() == 0.0) {
+		throw std::runtime_error("Invalid planewave propagation direction.");
+	}
+	propagation_ /= propagation_.Norml2();
+	if (std::abs(polarization_ * propagation_) > 1e-12 * polarization_.Norml2()) {
+		throw std::runtime_error("Planewave polarization must be normal to the propagation.");
+	}
+	if (attributes_.empty()) {
+		throw std::runtime_error("Planewaves need the attributes of a total field/scattered field surface.");
+	}
+}
+
+double Planewave::getAmplitude(const FieldType& f, const Direction& d) const
+{
+	switch (f) {
+	case E:
+		return polarization_[d];
+	default:
+		const auto d1{ (d + 1) % 3 };
+		const auto d2{ (d + 2) % 3 };
+		return propagation_[d1] * polarization_[d2] - propagation_[d2] * polarization_[d1];
+	}
+}
+
+double Planewave::getRetardedTime(const Position& pos, const Time& t) const
+{
+	double distance{ 0.0 };
+	for (int d = 0; d < pos.Size(); d++) {
+		distance += propagation_[d] * (pos[d] - center[d]);
+	}
+	return t - distance;
+}
+
+SeparableSource::SeparableSource(const Source& profile, const Waveform& waveform) :
+	profile_(profile.clone()),
+	waveform_(waveform.clone())
+{
+	if (profile_->isTimeDependent()) {
+		throw std::runtime_error("Separable source profiles can not be time dependent.");
+	}
+	fieldType = profile_->fieldType;
+	direction = profile_->direction;
+	center = profile_->center;
+}
+
+PointDipole::PointDipole(
+	const FieldType& ft,
+	const Direction& d,
+	const Position& position,
+	const Waveform& waveform,
+	const double moment,
+	const PointSourceType& type) :
+	waveform_(waveform.clone()),
+	moment_(moment),
+	type_(type)
+{
+	fieldType = ft;
+	direction = d;
+	center = position;
+}
+
 }
\ No newline at end of file
@@ -3,9 +3,13 @@
 #include <functional>
 #include <mfem.hpp>
 #include "Types.h"
+#include "Waveforms.h"
 
 namespace maxwell {
 
+// Physical coordinates of nodes, one row per node and one column per dimension.
+using NodalPositions = mfem::DenseMatrix;
+
 class Source {
 public:
 	using Position = mfem::Vector;
@@ -22,6 +26,11 @@ public:
 	virtual double eval2D(const mfem::Vector&) const = 0;
 	virtual double eval1D(const mfem::Vector&) const = 0;
 
+	// Adds the values at all positions in one call, dimension is the number of columns.
+	virtual void addValues(const NodalPositions&, mfem::Vector& res) const;
+
+	// Time dependent sources are added during the evolution instead of setting initial fields.
+	virtual bool isTimeDependent() const { return false; }
 };
 
 class GaussianInitialField : public Source {
@@ -46,6 +55,8 @@ public:
 	double eval2D(const mfem::Vector&) const;
 	double eval1D(const mfem::Vector&) const;
 
+	void addValues(const NodalPositions&, mfem::Vector& res) const;
+
 private:
 	double spread_{2.0};
 	double normalization_{1.0};
@@ -73,6 +84,8 @@ public:
 	double eval2D(const mfem::Vector&) const;
 	double eval1D(const mfem::Vector&) const;
 
+	void addValues(const NodalPositions&, mfem::Vector& res) const;
+
 private:
 
 	std::vector<std::size_t> modes_{ {0,0,0} };
@@ -81,8 +94,111 @@ private:
 	const void assembleModesVector(std::vector<std::size_t> modes);
 };
 
+/** Plane wave injected through a total field/scattered field surface.
+	The incident fields, in vacuum units, are
+		E = polarization * g(t - k . (x - center)),   H = k x E,
+	with k the unit propagation direction and g the waveform. The surface is
+	formed by the interior faces with the given boundary attributes, which
+	need no boundary condition. It encloses the total field region, which
+	must be surrounded by vacuum.
+	In 1D the evolved fields are Ey and Hz, and the propagation is along x.
+	*/
 class Planewave : public Source {
-	//To do
+public:
+	Planewave(
+		const Position& polarization,
+		const Position& propagation,
+		const Waveform&,
+		const std::vector<Attribute>& bdrAttributes,
+		const Position center = Position({ 0.0, 0.0, 0.0 })
+	);
+
+	std::unique_ptr<Source> clone() const {
+		return std::make_unique<Planewave>(*this);
+	}
+
+	// Incident fields are injected during the evolution, they have no initial value.
+	double eval3D(const mfem::Vector&) const { return 0.0; }
+	double eval2D(const mfem::Vector&) const { return 0.0; }
+	double eval1D(const mfem::Vector&) const { return 0.0; }
+	bool isTimeDependent() const { return true; }
+
+	const std::vector<Attribute>& getAttributes() const { return attributes_; }
+	const Waveform& getWaveform() const { return *waveform_; }
+
+	// Incident field component at a point, divided by the waveform value.
+	double getAmplitude(const FieldType&, const Direction&) const;
+	// Time at which the waveform is evaluated at a point.
+	double getRetardedTime(const Position&, const Time&) const;
+
+private:
+	Position polarization_;
+	Position propagation_;
+	std::shared_ptr<Waveform> waveform_;
+	std::vector<Attribute> attributes_;
+};
+
+/** Current density J(x, t) = profile(x) g(t) along the field type and
+	direction of the profile, which is any initial field source. Electric
+	currents add -J / epsilon to dE/dt and magnetic ones -J / mu to dH/dt.
+	In 1D only the field type of the profile is used.
+	*/
+class SeparableSource : public Source {
+public:
+	SeparableSource(const Source& profile, const Waveform&);
+
+	std::unique_ptr<Source> clone() const {
+		return std::make_unique<SeparableSource>(*this);
+	}
+
+	double eval3D(const mfem::Vector&) const { return 0.0; }
+	double eval2D(const mfem::Vector&) const { return 0.0; }
+	double eval1D(const mfem::Vector&) const { return 0.0; }
+	bool isTimeDependent() const { return true; }
+
+	const Source& getProfile() const { return *profile_; }
+	const Waveform& getWaveform() const { return *waveform_; }
+
+private:
+	std::shared_ptr<Source> profile_;
+	std::shared_ptr<Waveform> waveform_;
+};
+
+enum class PointSourceType {
+	// Current moment * g(t) along the direction, concentrated at the position.
+	Soft,
+	// Field value at the position forced to moment * g(t) after each step.
+	Hard
+};
+
+class PointDipole : public Source {
+public:
+	PointDipole(
+		const FieldType& ft,
+		const Direction& d,
+		const Position& position,
+		const Waveform&,
+		const double moment = 1.0,
+		const PointSourceType& = PointSourceType::Soft
+	);
+
+	std::unique_ptr<Source> clone() const {
+		return std::make_unique<PointDipole>(*this);
+	}
+
+	double eval3D(const mfem::Vector&) const { return 0.0; }
+	double eval2D(const mfem::Vector&) const { return 0.0; }
+	double eval1D(const mfem::Vector&) const { return 0.0; }
+	bool isTimeDependent() const { return true; }
+
+	const Waveform& getWaveform() const { return *waveform_; }
+	double getMoment() const { return moment_; }
+	const PointSourceType& getType() const { return type_; }
+
+private:
+	std::shared_ptr<Waveform> waveform_;
+	double moment_;
+	PointSourceType type_;
 };
 
 using Sources = std::vector<std::unique_ptr<Source>>;
@@ -4,6 +4,25 @@ namespace maxwell {
 
 using namespace mfem;
 
+NodalPositions buildNodalPositions(const FiniteElementSpace& fes)
+{
+    const auto dim{ fes.GetMesh()->Dimension() };
+    NodalPositions res(fes.GetNDofs(), dim);
+
+    DenseMatrix elemPositions;
+    Array<int> dofs;
+    for (int e = 0; e < fes.GetNE(); e++) {
+        fes.GetElementTransformation(e)->Transform(fes.GetFE(e)->GetNodes(), elemPositions);
+        fes.GetElementDofs(e, dofs);
+        for (int i = 0; i < dofs.Size(); i++) {
+            for (int d = 0; d < dim; d++) {
+                res(dofs[i], d) = elemPositions(d, i);
+            }
+        }
+    }
+    return res;
+}
+
 SourcesManager::SourcesManager(const Sources& srcs, const mfem::FiniteElementSpace& fes) :
 	fes_{fes}
 {
@@ -14,96 +33,30 @@ SourcesManager::SourcesManager(const Sources& srcs, const mfem::FiniteElementSpa
 
 void SourcesManager::setFields1D(Fields& fields)
 {
+    const auto positions{ buildNodalPositions(fes_) };
     for (const auto& source : sources) {
-
-        std::function<double(const Source::Position&)> f = 0;
-        if (dynamic_cast<GaussianInitialField*>(source.get())) {
-            f = std::bind(
-                &GaussianInitialField::eval1D, 
-                dynamic_cast<GaussianInitialField*>(source.get()),
-                std::placeholders::_1
-            );
-        }
-        else if (dynamic_cast<SinusoidalInitialField*>(source.get())) {
-            f = std::bind(
-                &SinusoidalInitialField::eval1D, 
-                dynamic_cast<SinusoidalInitialField*>(source.get()), 
-                std::placeholders::_1
-            );
-        }
-        else {
-            throw std::runtime_error("Invalid source type.");
-        }
-
-        switch (source.get()->fieldType) {
-        case FieldType::E:
-            fields.E1D.ProjectCoefficient(FunctionCoefficient(f));
-            break;
-        case FieldType::H:
-            fields.H1D.ProjectCoefficient(FunctionCoefficient(f));
-            break;
+        if (source->isTimeDependent()) {
+            continue;
         }
+        source->addValues(positions, source->fieldType == E ? fields.E1D : fields.H1D);
     }
 }
 
 void SourcesManager::setFields3D(Fields& fields)
 {
-    for (const auto& source : sources) {
-
-        std::function<double(const Source::Position&)> f = 0;
-        switch (fes_.GetMesh()->Dimension()) {
-        case 2:
-            if (dynamic_cast<GaussianInitialField*>(source.get())) {
-                f = std::bind(
-                    &GaussianInitialField::eval2D,
-                    dynamic_cast<GaussianInitialField*>(source.get()),
-                    std::placeholders::_1
-                );
-            }
-            else if (dynamic_cast<SinusoidalInitialField*>(source.get())) {
-                f = std::bind(
-                    &SinusoidalInitialField::eval2D,
-                    dynamic_cast<SinusoidalInitialField*>(source.get()),
-                    std::placeholders::_1
-                );
-            }
-            else {
-                throw std::runtime_error("Invalid source type.");
-            }
-            break;
-        case 3:
-            if (dynamic_cast<GaussianInitialField*>(source.get())) {
-                f = std::bind(
-                    &GaussianInitialField::eval3D,
-                    dynamic_cast<GaussianInitialField*>(source.get()),
-                    std::placeholders::_1
-                );
-            }
-            else if (dynamic_cast<SinusoidalInitialField*>(source.get())) {
-                f = std::bind(
-                    &SinusoidalInitialField::eval3D,
-                    dynamic_cast<SinusoidalInitialField*>(source.get()),
-                    std::placeholders::_1
-                );
-            }
-            else {
-                throw std::runtime_error("Invalid source type.");
-            }
-            break;
-        default:
-            throw std::exception("Incorrect Dimension for setFields3D");
-        }
+    const auto dim{ fes_.GetMesh()->Dimension() };
+    if (dim != 2 && dim != 3) {
+        throw std::runtime_error("Incorrect Dimension for setFields3D");
+    }
 
-        switch (source.get()->fieldType) {
-        case FieldType::E:
-            fields.E[source.get()->direction].ProjectCoefficient(FunctionCoefficient(f));
-            break;
-        case FieldType::H:
-            fields.H[source.get()->direction].ProjectCoefficient(FunctionCoefficient(f));
-            break;
+    const auto positions{ buildNodalPositions(fes_) };
+    for (const auto& source : sources) {
+        if (source->isTimeDependent()) {
+            continue;
         }
+        const auto d{ source->direction };
+        source->addValues(positions, source->fieldType == E ? fields.E[d] : fields.H[d]);
     }
 }
 
-
-}
\ No newline at end of file
+}
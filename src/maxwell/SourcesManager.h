@@ -6,6 +6,14 @@
 
 namespace maxwell {
 
+// Positions of the nodes of a nodal finite element space, in DoF order.
+NodalPositions buildNodalPositions(const mfem::FiniteElementSpace&);
+
+/** Sets initial fields from the sources which are not time dependent.
+	Nodal positions are computed once and each source adds its values at
+	all of them in a single call, so the sources of a field component are
+	superposed in one pass over its DoFs.
+	*/
 class SourcesManager {
 public:
     SourcesManager(const Sources&, const mfem::FiniteElementSpace&);  
@@ -18,4 +26,4 @@ private:
     const mfem::FiniteElementSpace& fes_;
 };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,150 @@
+#include "StateLayout.h"
+
+#include <algorithm>
+
+namespace maxwell {
+
+using namespace mfem;
+
+StateLayout::StateLayout(const FiniteElementSpace& fes, int numberOfComponents, const FieldsLayout& type) :
+	type_{ type },
+	components_{ numberOfComponents },
+	ndofs_{ fes.GetNDofs() }
+{
+	if (type_ != FieldsLayout::InterleavedByElement) {
+		return;
+	}
+
+	// Discontinuous spaces number the DoFs of each element consecutively.
+	elementBase_.assign(ndofs_, -1);
+	elementSize_.assign(ndofs_, 0);
+	Array<int> dofs;
+	for (int e = 0; e < fes.GetNE(); e++) {
+		fes.GetElementDofs(e, dofs);
+		const auto first{ dofs.Min() };
+		for (const auto& dof : dofs) {
+			if (dof - first >= dofs.Size() || elementBase_[dof] >= 0) {
+				throw std::runtime_error("Element interleaved layouts need the DoFs of each element to be consecutive.");
+			}
+			elementBase_[dof] = first * components_ + dof - first;
+			elementSize_[dof] = dofs.Size();
+		}
+	}
+	if (std::find(elementBase_.begin(), elementBase_.end(), -1) != elementBase_.end()) {
+		throw std::runtime_error("Element interleaved layouts need every DoF to belong to an element.");
+	}
+}
+
+void StateLayout::gather(const Vector& state, int c, Vector& component) const
+{
+	component.SetSize(ndofs_);
+	for (int j = 0; j < ndofs_; j++) {
+		component[j] = state[index(c, j)];
+	}
+}
+
+void StateLayout::scatter(const Vector& component, int c, Vector& state) const
+{
+	for (int j = 0; j < ndofs_; j++) {
+		state[index(c, j)] = component[j];
+	}
+}
+
+StateLayout::Terms StateLayout::groupByOperator(const Terms& terms)
+{
+	Terms res;
+	std::vector<bool> added(terms.size(), false);
+	for (std::size_t i{ 0 }; i < terms.size(); i++) {
+		if (added[i]) {
+			continue;
+		}
+		for (auto j{ i }; j < terms.size(); j++) {
+			if (!added[j] && terms[j].op == terms[i].op) {
+				res.push_back(terms[j]);
+				added[j] = true;
+			}
+		}
+	}
+	return res;
+}
+
+struct BlockedIndex {
+	int ndofs;
+	int operator()(int c, int dof) const { return c * ndofs + dof; }
+};
+
+struct NodeIndex {
+	int components;
+	int operator()(int c, int dof) const { return dof * components + c; }
+};
+
+struct ElementIndex {
+	const int* base;
+	const int* size;
+	int operator()(int c, int dof) const { return base[dof] + c * size[dof]; }
+};
+
+// Terms [begin, end) share their operator, whose rows are traversed once.
+template <typename Index>
+static void addMultGroup(
+	const StateLayout::Term* begin, const StateLayout::Term* end,
+	const double* in, double* out, const Index& index)
+{
+	const auto& A{ *begin->op };
+	const auto* I{ A.GetI() };
+	const auto* J{ A.GetJ() };
+	const auto* a{ A.GetData() };
+	const auto height{ A.Height() };
+	// Rows are split as in allocateByFirstTouch, see MemoryPlacement.h.
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < height; i++) {
+		for (auto t{ begin }; t != end; t++) {
+			double sum{ 0.0 };
+			for (int k = I[i]; k < I[i + 1]; k++) {
+				sum += a[k] * in[index(t->cIn, J[k])];
+			}
+			out[index(t->c, i)] += t->coefficient * sum;
+		}
+	}
+}
+
+template <typename Index>
+static void addMultTerms(const StateLayout::Terms& terms, const double* in, double* out, const Index& index)
+{
+	std::size_t begin{ 0 };
+	while (begin < terms.size()) {
+		auto end{ begin + 1 };
+		while (end < terms.size() && terms[end].op == terms[begin].op) {
+			end++;
+		}
+		// Lower bound of the traffic: matrix read once, input and output once per term.
+		const auto& A{ *terms[begin].op };
+		const auto count{ double(end - begin) };
+		const auto nnz{ double(A.NumNonZeroElems()) };
+		ScopedTimer timer{
+			getRegion(terms[begin].group),
+			count * A.Height(),
+			nnz * (sizeof(double) + sizeof(int)) + (A.Height() + 1.0) * sizeof(int) +
+			count * (A.Width() + 2.0 * A.Height()) * sizeof(double)
+		};
+		addMultGroup(&terms[begin], terms.data() + end, in, out, index);
+		begin = end;
+	}
+}
+
+void StateLayout::addMult(const Terms& terms, const Vector& in, Vector& out) const
+{
+	switch (type_) {
+	case FieldsLayout::InterleavedByNode:
+		addMultTerms(terms, in.GetData(), out.GetData(), NodeIndex{ components_ });
+		break;
+	case FieldsLayout::InterleavedByElement:
+		addMultTerms(terms, in.GetData(), out.GetData(), ElementIndex{ elementBase_.data(), elementSize_.data() });
+		break;
+	default:
+		addMultTerms(terms, in.GetData(), out.GetData(), BlockedIndex{ ndofs_ });
+		break;
+	}
+}
+
+}
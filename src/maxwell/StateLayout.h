@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+#include <mfem.hpp>
+
+#include "Types.h"
+#include "Profiler.h"
+
+namespace maxwell {
+
+// Field component of the state vector, 1D evolutions only use the field type.
+inline int getComponent(int dimension, const FieldType& f, const Direction& d)
+{
+	return dimension == 1 ? f : f * 3 + d;
+}
+
+/** Position of the field components in the state vector.
+	Blocked layouts store each component contiguously, Ex | Ey | ... | Hz.
+	Interleaved layouts store the components of each node, or the component
+	blocks of each element, next to each other. Terms of the evolution which
+	read several components of the same DoFs then find them in the same
+	cache lines. Auxiliary unknowns always follow the field components.
+	*/
+class StateLayout {
+public:
+	// Term of the evolution, out_c += coefficient * op in_cIn.
+	struct Term {
+		const mfem::SparseMatrix* op;
+		int c;
+		int cIn;
+		double coefficient;
+		// Region the term is timed in, terms sharing an operator share it.
+		OperatorGroup group{ OperatorGroup::Other };
+	};
+	using Terms = std::vector<Term>;
+
+	StateLayout(const mfem::FiniteElementSpace&, int numberOfComponents, const FieldsLayout& = FieldsLayout::Blocked);
+
+	const FieldsLayout& getType() const { return type_; }
+	bool isBlocked() const { return type_ == FieldsLayout::Blocked; }
+	int getNumberOfComponents() const { return components_; }
+	int getNDofs() const { return ndofs_; }
+	int getSize() const { return components_ * ndofs_; }
+
+	int index(int c, int dof) const
+	{
+		switch (type_) {
+		case FieldsLayout::InterleavedByNode:
+			return dof * components_ + c;
+		case FieldsLayout::InterleavedByElement:
+			return elementBase_[dof] + c * elementSize_[dof];
+		default:
+			return c * ndofs_ + dof;
+		}
+	}
+
+	void gather(const mfem::Vector& state, int c, mfem::Vector& component) const;
+	void scatter(const mfem::Vector& component, int c, mfem::Vector& state) const;
+
+	// Orders the terms so that the ones sharing an operator are consecutive.
+	static Terms groupByOperator(const Terms&);
+	// Adds all terms to out, traversing once each group of terms sharing an operator.
+	// Each group is timed in the region of its operator group, see Profiler.h.
+	void addMult(const Terms&, const mfem::Vector& in, mfem::Vector& out) const;
+
+private:
+	FieldsLayout type_;
+	int components_;
+	int ndofs_;
+	// Interleaved by element: index(c, dof) = elementBase_[dof] + c * elementSize_[dof].
+	std::vector<int> elementBase_, elementSize_;
+};
+
+}
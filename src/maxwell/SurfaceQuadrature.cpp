@@ -0,0 +1,118 @@
+#include "SurfaceQuadrature.h"
+
+#include <algorithm>
+
+namespace maxwell {
+
+using namespace mfem;
+
+namespace {
+
+// A null interiorAttribute keeps the element on the first side of interior faces.
+SurfaceQuadrature buildQuadrature(const FiniteElementSpace& fes, const std::vector<Attribute>& bdrAttributes, const Attribute* interiorAttribute)
+{
+	auto& mesh{ *fes.GetMesh() };
+	const auto dim{ mesh.Dimension() };
+
+	SurfaceQuadrature res;
+	Array<int> dofs;
+	Vector shape, nor(dim), pos;
+	for (int be = 0; be < mesh.GetNBE(); be++) {
+		const auto& atts{ bdrAttributes };
+		if (std::find(atts.begin(), atts.end(), mesh.GetBdrAttribute(be)) == atts.end()) {
+			continue;
+		}
+
+		auto* T{ mesh.GetFaceElementTransformations(mesh.GetBdrElementEdgeIndex(be)) };
+		bool fromSecondSide{ false };
+		if (T->Elem2No >= 0 && interiorAttribute) {
+			if (mesh.GetAttribute(T->Elem1No) != *interiorAttribute) {
+				if (mesh.GetAttribute(T->Elem2No) != *interiorAttribute) {
+					throw std::runtime_error("Interior face with boundary attribute " +
+						std::to_string(mesh.GetBdrAttribute(be)) + " has no element of attribute " +
+						std::to_string(*interiorAttribute) + ".");
+				}
+				fromSecondSide = true;
+			}
+		}
+		const auto elem{ fromSecondSide ? T->Elem2No : T->Elem1No };
+		auto* elemT{ fromSecondSide ? T->Elem2 : T->Elem1 };
+		const auto* fe{ fes.GetFE(elem) };
+		fes.GetElementDofs(elem, dofs);
+		const auto ndof{ fe->GetDof() };
+		shape.SetSize(ndof);
+
+		std::vector<double> w(ndof, 0.0);
+		Points wn(ndof, Point(3, 0.0));
+		const auto& ir{ IntRules.Get(T->GetGeometryType(), 2 * fe->GetOrder() + T->OrderW()) };
+		for (int q = 0; q < ir.GetNPoints(); q++) {
+			const auto& ip{ ir.IntPoint(q) };
+			T->SetAllIntPoints(&ip);
+			const auto& eip{ fromSecondSide ? T->GetElement2IntPoint() : T->GetElement1IntPoint() };
+			fe->CalcShape(eip, shape);
+			if (dim == 1) {
+				nor(0) = 2 * eip.x - 1.0;
+			}
+			else {
+				CalcOrtho(T->Jacobian(), nor);
+				if (fromSecondSide) {
+					nor.Neg();
+				}
+			}
+			const auto area{ nor.Norml2() };
+			for (int i = 0; i < ndof; i++) {
+				w[i] += ip.weight * shape[i] * area;
+				for (int d = 0; d < dim; d++) {
+					wn[i][d] += ip.weight * shape[i] * nor[d];
+				}
+			}
+		}
+
+		for (int i = 0; i < ndof; i++) {
+			if (w[i] == 0.0) {
+				continue;
+			}
+			elemT->Transform(fe->GetNodes().IntPoint(i), pos);
+			Point position(3, 0.0);
+			for (int d = 0; d < pos.Size(); d++) {
+				position[d] = pos[d];
+			}
+			res.dofs.push_back(dofs[i]);
+			res.weights.push_back(w[i]);
+			res.normalWeights.push_back(wn[i]);
+			res.positions.push_back(position);
+		}
+	}
+
+	if (res.size() == 0) {
+		throw std::runtime_error("No boundary elements found for the surface attributes.");
+	}
+	return res;
+}
+
+}
+
+SurfaceQuadrature buildSurfaceQuadrature(const FiniteElementSpace& fes, const std::vector<Attribute>& bdrAttributes)
+{
+	auto& mesh{ *fes.GetMesh() };
+	for (int be = 0; be < mesh.GetNBE(); be++) {
+		const auto& atts{ bdrAttributes };
+		if (std::find(atts.begin(), atts.end(), mesh.GetBdrAttribute(be)) == atts.end()) {
+			continue;
+		}
+		int e1, e2;
+		mesh.GetFaceElements(mesh.GetBdrElementEdgeIndex(be), &e1, &e2);
+		if (e2 >= 0) {
+			throw std::runtime_error("Boundary attribute " + std::to_string(mesh.GetBdrAttribute(be)) +
+				" marks interior faces, which need the attribute of the elements the normals point out of.");
+		}
+	}
+	return buildQuadrature(fes, bdrAttributes, nullptr);
+}
+
+SurfaceQuadrature buildSurfaceQuadrature(const FiniteElementSpace& fes, const std::vector<Attribute>& bdrAttributes, Attribute interiorAttribute)
+{
+	return buildQuadrature(fes, bdrAttributes, &interiorAttribute);
+}
+
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <mfem.hpp>
+
+#include "Types.h"
+
+namespace maxwell {
+
+/** Nodal quadrature over the faces of a set of boundary attributes.
+	There is one entry per face and DoF of the element the normal points out
+	of. Each entry holds the integral of the DoF shape function over the
+	face, alone and multiplied by that unit normal, so that a surface
+	integral of a nodal quantity q reduces to
+		sum_k weight_k * q[dof_k]   or   sum_k normalWeights_k . q[dof_k].
+	On exterior boundaries the normal points out of the domain.
+	*/
+struct SurfaceQuadrature {
+	std::vector<int> dofs;
+	std::vector<double> weights;
+	Points normalWeights;
+	Points positions;
+
+	std::size_t size() const { return dofs.size(); }
+};
+
+// Throws if the attributes mark interior faces, whose orientation would be arbitrary.
+SurfaceQuadrature buildSurfaceQuadrature(const mfem::FiniteElementSpace&, const std::vector<Attribute>& bdrAttributes);
+
+// Normals of interior faces point out of the elements with interiorAttribute.
+SurfaceQuadrature buildSurfaceQuadrature(const mfem::FiniteElementSpace&, const std::vector<Attribute>& bdrAttributes, Attribute interiorAttribute);
+
+}
@@ -0,0 +1,193 @@
+#include "TotalFieldScatteredField.h"
+
+#include <algorithm>
+#include <set>
+#include <tuple>
+
+namespace maxwell {
+
+using namespace mfem;
+
+struct SurfaceFace {
+	int elem1, elem2;
+};
+
+// Interior faces of the surface and the elements on both of their sides.
+static std::vector<SurfaceFace> buildSurfaceFaces(Mesh& mesh, const std::vector<Attribute>& atts)
+{
+	std::vector<SurfaceFace> res;
+	for (int be = 0; be < mesh.GetNBE(); be++) {
+		if (std::find(atts.begin(), atts.end(), mesh.GetBdrAttribute(be)) == atts.end()) {
+			continue;
+		}
+		SurfaceFace face;
+		mesh.GetFaceElements(mesh.GetBdrElementEdgeIndex(be), &face.elem1, &face.elem2);
+		if (face.elem2 < 0) {
+			throw std::runtime_error("Total field/scattered field surfaces must be formed by interior faces.");
+		}
+		res.push_back(face);
+	}
+	if (res.empty()) {
+		throw std::runtime_error("No faces found for the total field/scattered field surface.");
+	}
+	return res;
+}
+
+static int findRoot(std::vector<int>& parent, int e)
+{
+	while (parent[e] != e) {
+		parent[e] = parent[parent[e]];
+		e = parent[e];
+	}
+	return e;
+}
+
+// Elements which can not be reached from the exterior boundary of the mesh
+// without crossing the surface. Unlike a test against the centroid of the
+// surface, this holds for surfaces of any shape.
+static std::vector<bool> buildInsideElements(Mesh& mesh, const std::vector<SurfaceFace>& surface)
+{
+	std::set<std::pair<int, int>> cut;
+	for (const auto& face : surface) {
+		cut.emplace(std::min(face.elem1, face.elem2), std::max(face.elem1, face.elem2));
+	}
+
+	std::vector<int> parent(mesh.GetNE());
+	for (int e = 0; e < mesh.GetNE(); e++) {
+		parent[e] = e;
+	}
+	std::vector<int> exterior;
+	for (int f = 0; f < mesh.GetNumFaces(); f++) {
+		int e1, e2;
+		mesh.GetFaceElements(f, &e1, &e2);
+		if (e2 < 0) {
+			exterior.push_back(e1);
+		}
+		else if (cut.find({ std::min(e1, e2), std::max(e1, e2) }) == cut.end()) {
+			parent[findRoot(parent, e1)] = findRoot(parent, e2);
+		}
+	}
+
+	std::vector<bool> reachable(mesh.GetNE(), false);
+	for (const auto& e : exterior) {
+		reachable[findRoot(parent, e)] = true;
+	}
+	std::vector<bool> res(mesh.GetNE());
+	for (int e = 0; e < mesh.GetNE(); e++) {
+		res[e] = !reachable[findRoot(parent, e)];
+	}
+	return res;
+}
+
+TotalFieldScatteredField::TotalFieldScatteredField(
+	FiniteElementSpace& fes,
+	const Planewave& planewave,
+	const Components& components,
+	const std::vector<Term>& terms,
+	const StateLayout& layout) :
+	waveform_{ planewave.getWaveform().clone() }
+{
+	auto& mesh{ *fes.GetMesh() };
+	const auto ndofs{ fes.GetNDofs() };
+	const auto faces{ buildSurfaceFaces(mesh, planewave.getAttributes()) };
+
+	const auto inside{ buildInsideElements(mesh, faces) };
+
+	// Elements next to the surface, 1 if they are inside and -1 if outside.
+	std::vector<int> side(mesh.GetNE(), 0);
+	std::vector<int> elems;
+	for (const auto& face : faces) {
+		if (inside[face.elem1] == inside[face.elem2]) {
+			throw std::runtime_error("Total field/scattered field surfaces must separate an inner region from the boundary of the mesh.");
+		}
+		side[face.elem1] = inside[face.elem1] ? 1 : -1;
+		side[face.elem2] = inside[face.elem2] ? 1 : -1;
+		elems.push_back(face.elem1);
+		elems.push_back(face.elem2);
+	}
+	std::sort(elems.begin(), elems.end());
+	elems.erase(std::unique(elems.begin(), elems.end()), elems.end());
+
+	std::vector<int> dofElement(ndofs, -1);
+	std::vector<double> dofDelay(ndofs, 0.0);
+	Array<int> dofs;
+	Vector pos;
+	for (const auto& e : elems) {
+		const auto* fe{ fes.GetFE(e) };
+		auto* T{ mesh.GetElementTransformation(e) };
+		fes.GetElementDofs(e, dofs);
+		for (int i = 0; i < dofs.Size(); i++) {
+			T->Transform(fe->GetNodes().IntPoint(i), pos);
+			dofElement[dofs[i]] = e;
+			dofDelay[dofs[i]] = -planewave.getRetardedTime(pos, 0.0);
+		}
+	}
+
+	auto getComponent = [&](const FieldType& f, const Direction& c) {
+		const auto it{ std::find(components.begin(), components.end(), std::make_pair(f, c)) };
+		if (it == components.end()) {
+			throw std::runtime_error("Field component is not in the state vector.");
+		}
+		return (int) (it - components.begin());
+	};
+
+	std::vector<int> rowIndex(components.size() * ndofs, -1), columnIndex(ndofs, -1);
+	std::vector<int> columns;
+	std::vector<std::tuple<int, int, double>> entries;
+	for (const auto& t : terms) {
+		const auto amplitude{ t.coefficient * planewave.getAmplitude(t.fIn, t.cIn) };
+		if (amplitude == 0.0) {
+			continue;
+		}
+		const auto& A{ t.op->SpMat() };
+		const auto component{ getComponent(t.f, t.c) };
+		for (const auto& e : elems) {
+			fes.GetElementDofs(e, dofs);
+			for (const auto& dof : dofs) {
+				for (int k = A.GetI()[dof]; k < A.GetI()[dof + 1]; k++) {
+					const auto col{ A.GetJ()[k] };
+					if (dofElement[col] < 0 || side[dofElement[col]] != -side[e]) {
+						continue;
+					}
+					const auto index{ layout.index(component, dof) };
+					auto& row{ rowIndex[index] };
+					if (row < 0) {
+						row = rows_.Size();
+						rows_.Append(index);
+					}
+					if (columnIndex[col] < 0) {
+						columnIndex[col] = (int) columns.size();
+						columns.push_back(col);
+					}
+					entries.emplace_back(row, columnIndex[col], side[e] * amplitude * A.GetData()[k]);
+				}
+			}
+		}
+	}
+
+	K_ = std::make_unique<SparseMatrix>(rows_.Size(), (int) columns.size());
+	for (const auto& entry : entries) {
+		K_->Add(std::get<0>(entry), std::get<1>(entry), std::get<2>(entry));
+	}
+	K_->Finalize();
+
+	delays_.SetSize((int) columns.size());
+	for (std::size_t j{ 0 }; j < columns.size(); j++) {
+		delays_[(int) j] = dofDelay[columns[j]];
+	}
+	incident_.SetSize(delays_.Size());
+	injection_.SetSize(rows_.Size());
+}
+
+void TotalFieldScatteredField::addTerms(const Time& time, Vector& out) const
+{
+	for (int j = 0; j < delays_.Size(); j++) {
+		incident_[j] = waveform_->eval(time - delays_[j]);
+	}
+	K_->Mult(incident_, injection_);
+	for (int i = 0; i < rows_.Size(); i++) {
+		out[rows_[i]] += injection_[i];
+	}
+}
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <mfem.hpp>
+
+#include "Sources.h"
+#include "SourceTerm.h"
+
+namespace maxwell {
+
+/** Total field/scattered field injection of a plane wave.
+	Elements inside the surface hold the total field and elements outside
+	hold the scattered field. Inside elements are those which can not be
+	reached from the exterior boundary of the mesh without crossing the
+	surface, so the surface must be closed but may have any shape. The
+	evolution L only couples elements through their faces, so evolving the
+	total field everywhere and subtracting the incident field outside
+	reduces to
+		dU/dt = L U + L_(in,out) U_inc - L_(out,in) U_inc,
+	where L_(in,out) are the entries of the evolution terms with rows in an
+	inner element and columns in its outer neighbour across the surface,
+	and conversely. These entries are gathered once, scaled by the incident
+	field amplitudes, into an operator from the DoFs next to the surface to
+	the rows they affect. Each stage then evaluates the waveform at the
+	retarded time of those DoFs and applies that operator.
+	*/
+class TotalFieldScatteredField : public SourceTerm {
+public:
+	// Term of the evolution, out_(f, c) += coefficient * op in_(fIn, cIn).
+	struct Term {
+		FieldType f;
+		Direction c;
+		const mfem::BilinearForm* op;
+		FieldType fIn;
+		Direction cIn;
+		double coefficient;
+	};
+	// Field components of the state vector, in order.
+	using Components = std::vector<std::pair<FieldType, Direction>>;
+
+	TotalFieldScatteredField(mfem::FiniteElementSpace&, const Planewave&, const Components&, const std::vector<Term>&, const StateLayout&);
+
+	void addTerms(const Time&, mfem::Vector& out) const;
+
+private:
+	std::unique_ptr<Waveform> waveform_;
+
+	mfem::Array<int> rows_;
+	mfem::Vector delays_;
+	std::unique_ptr<mfem::SparseMatrix> K_;
+	mutable mfem::Vector incident_, injection_;
+};
+
+}
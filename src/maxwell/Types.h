@@ -3,6 +3,7 @@
 #include <array>
 #include <vector>
 #include <map>
+#include <string>
 
 namespace maxwell {
 
@@ -10,6 +11,8 @@ using Time = double;
 using FieldFrame = std::vector<double>;
 using FieldMovie = std::map<Time, FieldFrame>;
 
+using Attribute = int;
+
 using Point = std::vector<double>;
 using Points = std::vector<Point>;
 
@@ -33,8 +36,39 @@ enum class BdrCond {
 	SMA
 };
 
+// Element numbering applied before the finite element space is built.
+enum class ElementOrdering {
+	None,
+	Hilbert,
+	Morton,
+	ReverseCuthillMcKee
+};
+
+// Position of the field components in the state vector, see StateLayout.
+enum class FieldsLayout {
+	Blocked,
+	InterleavedByNode,
+	InterleavedByElement
+};
+
+// Placement in memory of the state vectors and of the operators, see MemoryPlacement.h.
+struct MemoryPlacementOptions {
+	// Initializes them in parallel with the partition of the kernels, so each
+	// page is backed by the NUMA node of the thread that later works on it.
+	bool firstTouch{ false };
+	// Asks for transparent huge pages, where available.
+	bool hugePages{ false };
+};
+
 struct MaxwellEvolOptions {
 	FluxType fluxType{ FluxType::Upwind };
+	FieldsLayout fieldsLayout{ FieldsLayout::Blocked };
+	MemoryPlacementOptions memoryPlacement;
+	// Directory to cache assembled operators in. Empty disables caching.
+	std::string operatorCacheDirectory;
+	// Cached operators are used in place from the copy on write mapped file,
+	// so processes running the same configuration share their memory pages.
+	bool shareCachedOperators{ false };
 };
 
 
@@ -0,0 +1,93 @@
+#include "Waveforms.h"
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace maxwell {
+
+GaussianPulse::GaussianPulse(const double spread, const double delay, const double amplitude) :
+	spread_{ spread },
+	delay_{ delay },
+	amplitude_{ amplitude }
+{
+	if (spread_ <= 0.0) {
+		throw std::runtime_error("Invalid spread value.");
+	}
+}
+
+double GaussianPulse::eval(const Time& t) const
+{
+	return amplitude_ * std::exp(-std::pow(t - delay_, 2) / (2.0 * std::pow(spread_, 2)));
+}
+
+ModulatedGaussianPulse::ModulatedGaussianPulse(const double spread, const double delay, const double frequency, const double amplitude) :
+	envelope_{ spread, delay, amplitude },
+	delay_{ delay },
+	frequency_{ frequency }
+{
+	if (frequency_ <= 0.0) {
+		throw std::runtime_error("Invalid frequency value.");
+	}
+}
+
+double ModulatedGaussianPulse::eval(const Time& t) const
+{
+	return envelope_.eval(t) * std::sin(2.0 * M_PI * frequency_ * (t - delay_));
+}
+
+RampedSinusoid::RampedSinusoid(const double frequency, const double rampTime, const double amplitude, const double phase) :
+	frequency_{ frequency },
+	rampTime_{ rampTime },
+	amplitude_{ amplitude },
+	phase_{ phase }
+{
+	if (frequency_ <= 0.0) {
+		throw std::runtime_error("Invalid frequency value.");
+	}
+	if (rampTime_ < 0.0) {
+		throw std::runtime_error("Invalid ramp time value.");
+	}
+}
+
+double RampedSinusoid::eval(const Time& t) const
+{
+	if (t <= 0.0) {
+		return 0.0;
+	}
+	auto res{ amplitude_ * std::sin(2.0 * M_PI * frequency_ * t + phase_) };
+	if (t < rampTime_) {
+		res *= 0.5 * (1.0 - std::cos(M_PI * t / rampTime_));
+	}
+	return res;
+}
+
+SampledWaveform::SampledWaveform(const std::vector<Time>& times, const std::vector<double>& values) :
+	times_{ times },
+	values_{ values }
+{
+	if (times_.size() < 2 || times_.size() != values_.size()) {
+		throw std::runtime_error("Sampled waveforms need at least two times and one value per time.");
+	}
+	if (!std::is_sorted(times_.begin(), times_.end()) ||
+		std::adjacent_find(times_.begin(), times_.end()) != times_.end()) {
+		throw std::runtime_error("Sampled waveform times must be strictly increasing.");
+	}
+}
+
+double SampledWaveform::eval(const Time& t) const
+{
+	if (t < times_.front() || t > times_.back()) {
+		return 0.0;
+	}
+	const auto i{ (std::size_t) (std::upper_bound(times_.begin(), times_.end(), t) - times_.begin()) - 1 };
+	if (i + 1 == times_.size()) {
+		return values_.back();
+	}
+	const auto s{ (t - times_[i]) / (times_[i + 1] - times_[i]) };
+	return (1.0 - s) * values_[i] + s * values_[i + 1];
+}
+
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Types.h"
+
+namespace maxwell {
+
+class Waveform {
+public:
+	virtual ~Waveform() = default;
+	virtual std::unique_ptr<Waveform> clone() const = 0;
+
+	virtual double eval(const Time&) const = 0;
+};
+
+// amplitude * exp(-(t - delay)^2 / (2 spread^2)).
+class GaussianPulse : public Waveform {
+public:
+	GaussianPulse(const double spread, const double delay, const double amplitude = 1.0);
+
+	std::unique_ptr<Waveform> clone() const {
+		return std::make_unique<GaussianPulse>(*this);
+	}
+
+	double eval(const Time&) const;
+
+private:
+	double spread_;
+	double delay_;
+	double amplitude_;
+};
+
+// Gaussian pulse times sin(2 pi frequency (t - delay)), with no DC content.
+class ModulatedGaussianPulse : public Waveform {
+public:
+	ModulatedGaussianPulse(const double spread, const double delay, const double frequency, const double amplitude = 1.0);
+
+	std::unique_ptr<Waveform> clone() const {
+		return std::make_unique<ModulatedGaussianPulse>(*this);
+	}
+
+	double eval(const Time&) const;
+
+private:
+	GaussianPulse envelope_;
+	double delay_;
+	double frequency_;
+};
+
+// amplitude * sin(2 pi frequency t + phase), starting at t = 0 with a raised cosine ramp.
+class RampedSinusoid : public Waveform {
+public:
+	RampedSinusoid(const double frequency, const double rampTime, const double amplitude = 1.0, const double phase = 0.0);
+
+	std::unique_ptr<Waveform> clone() const {
+		return std::make_unique<RampedSinusoid>(*this);
+	}
+
+	double eval(const Time&) const;
+
+private:
+	double frequency_;
+	double rampTime_;
+	double amplitude_;
+	double phase_;
+};
+
+// Linear interpolation of user samples, zero outside of them.
+class SampledWaveform : public Waveform {
+public:
+	SampledWaveform(const std::vector<Time>& times, const std::vector<double>& values);
+
+	std::unique_ptr<Waveform> clone() const {
+		return std::make_unique<SampledWaveform>(*this);
+	}
+
+	double eval(const Time&) const;
+
+private:
+	std::vector<Time> times_;
+	std::vector<double> values_;
+};
+
+}
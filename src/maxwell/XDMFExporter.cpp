@@ -0,0 +1,237 @@
+#include "XDMFExporter.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+
+namespace maxwell {
+
+using namespace mfem;
+
+std::string toXDMFTopologyType(const Geometry::Type& geom)
+{
+	switch (geom) {
+	case Geometry::SEGMENT:
+		return "Polyline\" NodesPerElement=\"2";
+	case Geometry::TRIANGLE:
+		return "Triangle";
+	case Geometry::SQUARE:
+		return "Quadrilateral";
+	case Geometry::TETRAHEDRON:
+		return "Tetrahedron";
+	case Geometry::CUBE:
+		return "Hexahedron";
+	default:
+		throw std::runtime_error("Element geometry not supported by XDMF exporter.");
+	}
+}
+
+// Data items are resolved relative to the index, which is next to the container.
+std::string getFileName(const std::string& path)
+{
+	return path.substr(path.find_last_of("/\\") + 1);
+}
+
+bool isElementInBox(const Mesh& mesh, int e, const Point& boxMin, const Point& boxMax)
+{
+	Array<int> vertices;
+	mesh.GetElementVertices(e, vertices);
+	for (int d = 0; d < mesh.SpaceDimension(); d++) {
+		auto elMin{ std::numeric_limits<double>::max() };
+		auto elMax{ std::numeric_limits<double>::lowest() };
+		for (const auto& v : vertices) {
+			elMin = std::min(elMin, mesh.GetVertex(v)[d]);
+			elMax = std::max(elMax, mesh.GetVertex(v)[d]);
+		}
+		if (elMax < boxMin[d] || elMin > boxMax[d]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+XDMFExporter::XDMFExporter(const std::string& name, const ExporterOptions& opts, const FiniteElementSpace& fes, Fields& fields) :
+	xdmfFilename_{ name + ".xdmf" },
+	binFilename_{ name + ".bin" },
+	bin_{ binFilename_, std::ios::binary | std::ios::trunc },
+	opts_{ opts },
+	fes_{ fes }
+{
+	if (!bin_) {
+		throw std::runtime_error("Could not open XDMF container file " + binFilename_);
+	}
+	const std::size_t dim( fes_.GetMesh()->SpaceDimension() );
+	if ((!opts_.boxMin.empty() || !opts_.boxMax.empty()) &&
+		(opts_.boxMin.size() != dim || opts_.boxMax.size() != dim)) {
+		throw std::runtime_error("Export box corners must have as many coordinates as the mesh dimension.");
+	}
+	registerFields(fields);
+	writeMesh();
+	buffer_.SetSize(numberOfPoints_);
+	if (opts_.singlePrecision) {
+		singleBuffer_.resize(numberOfPoints_);
+	}
+	index_.open(xdmfFilename_, std::ios::trunc);
+	if (!index_) {
+		throw std::runtime_error("Could not open XDMF index file " + xdmfFilename_);
+	}
+	writeIndexHeader();
+}
+
+std::vector<int> XDMFExporter::buildExportedElements() const
+{
+	const auto& mesh{ *fes_.GetMesh() };
+	std::vector<int> res;
+	for (int e = 0; e < mesh.GetNE(); e++) {
+		const auto& atts{ opts_.attributes };
+		if (!atts.empty() && std::find(atts.begin(), atts.end(), mesh.GetAttribute(e)) == atts.end()) {
+			continue;
+		}
+		if (!opts_.boxMin.empty() && !isElementInBox(mesh, e, opts_.boxMin, opts_.boxMax)) {
+			continue;
+		}
+		res.push_back(e);
+	}
+	if (res.empty()) {
+		throw std::runtime_error("No elements selected for XDMF export.");
+	}
+	return res;
+}
+
+void XDMFExporter::registerFields(Fields& fields)
+{
+	const auto dim{ fes_.GetMesh()->Dimension() };
+	for (const auto& c : buildExportedComponents(opts_, dim)) {
+		fields_.push_back({ getComponentName(c, dim), &fields.get(c.fieldType, c.direction) });
+	}
+}
+
+void XDMFExporter::writeMesh()
+{
+	const auto& mesh{ *fes_.GetMesh() };
+	const auto elements{ buildExportedElements() };
+	const auto geom{ mesh.GetElementBaseGeometry(elements.front()) };
+	for (const auto& e : elements) {
+		if (mesh.GetElementBaseGeometry(e) != geom) {
+			throw std::runtime_error("XDMF exporter requires a mesh with a single element type.");
+		}
+	}
+
+	const auto lod{ opts_.levelsOfDetail > 0 ? opts_.levelsOfDetail : fes_.GetMaxElementOrder() };
+	const auto* refGeom{ GlobGeometryRefiner.Refine(geom, std::max(lod, 1)) };
+	const auto& refPts{ refGeom->RefPts };
+	verticesPerCell_ = Geometry::NumVerts[geom];
+	const auto cellsPerElement{ refGeom->RefGeoms.Size() / verticesPerCell_ };
+
+	topologyType_ = toXDMFTopologyType(geom);
+	const auto numberOfElements{ int(elements.size()) };
+	numberOfPoints_ = numberOfElements * refPts.GetNPoints();
+	numberOfCells_ = numberOfElements * cellsPerElement;
+
+	// Points are duplicated per element as DG fields are discontinuous.
+	std::vector<double> coords;
+	coords.reserve(3 * numberOfPoints_);
+	std::vector<int> connectivity;
+	connectivity.reserve(numberOfCells_ * verticesPerCell_);
+
+	interpolator_ = std::make_unique<SparseMatrix>(numberOfPoints_, fes_.GetNDofs());
+	Vector shape, pos;
+	Array<int> dofs;
+	for (int k = 0; k < numberOfElements; k++) {
+		const auto e{ elements[k] };
+		const auto pointOffset{ k * refPts.GetNPoints() };
+		auto* T{ fes_.GetElementTransformation(e) };
+		const auto* fe{ fes_.GetFE(e) };
+		fes_.GetElementDofs(e, dofs);
+		shape.SetSize(fe->GetDof());
+		for (int i = 0; i < refPts.GetNPoints(); i++) {
+			const auto& ip{ refPts.IntPoint(i) };
+			T->SetIntPoint(&ip);
+			T->Transform(ip, pos);
+			for (int d = 0; d < 3; d++) {
+				coords.push_back(d < pos.Size() ? pos[d] : 0.0);
+			}
+			fe->CalcShape(ip, shape);
+			for (int j = 0; j < dofs.Size(); j++) {
+				interpolator_->Add(pointOffset + i, dofs[j], shape[j]);
+			}
+		}
+		for (int i = 0; i < refGeom->RefGeoms.Size(); i++) {
+			connectivity.push_back(pointOffset + refGeom->RefGeoms[i]);
+		}
+	}
+	interpolator_->Finalize();
+
+	geometryOffset_ = bin_.tellp();
+	bin_.write(reinterpret_cast<const char*>(coords.data()), coords.size() * sizeof(double));
+	topologyOffset_ = bin_.tellp();
+	bin_.write(reinterpret_cast<const char*>(connectivity.data()), connectivity.size() * sizeof(int));
+	bin_.flush();
+}
+
+void XDMFExporter::save(double time)
+{
+	const auto offset{ bin_.tellp() };
+	for (const auto& f : fields_) {
+		interpolator_->Mult(*f.field, buffer_);
+		if (opts_.singlePrecision) {
+			std::copy(buffer_.GetData(), buffer_.GetData() + numberOfPoints_, singleBuffer_.begin());
+			bin_.write(reinterpret_cast<const char*>(singleBuffer_.data()), numberOfPoints_ * sizeof(float));
+		}
+		else {
+			bin_.write(reinterpret_cast<const char*>(buffer_.GetData()), numberOfPoints_ * sizeof(double));
+		}
+	}
+	bin_.flush();
+	appendToIndex(time, offset);
+}
+
+void XDMFExporter::writeIndexHeader()
+{
+	const auto binFilename{ getFileName(binFilename_) };
+	index_ << std::setprecision(17);
+	index_ << "<?xml version=\"1.0\" ?>\n";
+	index_ << "<Xdmf Version=\"3.0\">\n";
+	index_ << "<Domain>\n";
+	index_ << "<Topology Name=\"T\" TopologyType=\"" << topologyType_ << "\" NumberOfElements=\"" << numberOfCells_ << "\">\n";
+	index_ << "  <DataItem Dimensions=\"" << numberOfCells_ << " " << verticesPerCell_ << "\" NumberType=\"Int\" Precision=\"" << sizeof(int)
+		<< "\" Format=\"Binary\" Endian=\"Little\" Seek=\"" << topologyOffset_ << "\">" << binFilename << "</DataItem>\n";
+	index_ << "</Topology>\n";
+	index_ << "<Geometry Name=\"G\" GeometryType=\"XYZ\">\n";
+	index_ << "  <DataItem Dimensions=\"" << numberOfPoints_ << " 3\" NumberType=\"Float\" Precision=\"8\""
+		<< " Format=\"Binary\" Endian=\"Little\" Seek=\"" << geometryOffset_ << "\">" << binFilename << "</DataItem>\n";
+	index_ << "</Geometry>\n";
+	index_ << "<Grid Name=\"TimeSeries\" GridType=\"Collection\" CollectionType=\"Temporal\">\n";
+	writeIndexClosingTags();
+}
+
+void XDMFExporter::appendToIndex(double time, std::streamoff offset)
+{
+	const auto binFilename{ getFileName(binFilename_) };
+	index_.seekp(indexEnd_);
+	index_ << "<Grid Name=\"Mesh\" GridType=\"Uniform\">\n";
+	index_ << "  <Time Value=\"" << time << "\"/>\n";
+	index_ << "  <Topology Reference=\"XML\">/Xdmf/Domain/Topology[@Name=\"T\"]</Topology>\n";
+	index_ << "  <Geometry Reference=\"XML\">/Xdmf/Domain/Geometry[@Name=\"G\"]</Geometry>\n";
+	for (const auto& f : fields_) {
+		index_ << "  <Attribute Name=\"" << f.name << "\" AttributeType=\"Scalar\" Center=\"Node\">\n";
+		index_ << "    <DataItem Dimensions=\"" << numberOfPoints_ << "\" NumberType=\"Float\" Precision=\"" << getFieldPrecision() << "\""
+			<< " Format=\"Binary\" Endian=\"Little\" Seek=\"" << offset << "\">" << binFilename << "</DataItem>\n";
+		index_ << "  </Attribute>\n";
+		offset += numberOfPoints_ * getFieldPrecision();
+	}
+	index_ << "</Grid>\n";
+	writeIndexClosingTags();
+}
+
+void XDMFExporter::writeIndexClosingTags()
+{
+	// The index only grows, so the closing tags are always overwritten by the next grid.
+	indexEnd_ = index_.tellp();
+	index_ << "</Grid>\n";
+	index_ << "</Domain>\n";
+	index_ << "</Xdmf>\n";
+	index_.flush();
+}
+
+}
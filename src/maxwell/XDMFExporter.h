@@ -0,0 +1,68 @@
+#pragma once
+
+#include <fstream>
+#include <mfem.hpp>
+
+#include "Fields.h"
+#include "Probes.h"
+
+namespace maxwell {
+
+/** Time series exporter writing a single binary container and an XDMF index.
+	Geometry and topology of the (refined) mesh are written only once, at the
+	beginning of the container. Each call to save() appends the registered
+	field arrays to the container and their grid to the XDMF index, writing
+	over its closing tags, so saving costs the same for every snapshot.
+	Fields are evaluated at the refined points through a precomputed sparse
+	interpolation matrix, so each snapshot costs one SpMV per field.
+	Only the components and elements selected in the ExporterOptions are
+	written, field arrays optionally in single precision. Geometry is
+	always written in double precision.
+	*/
+class XDMFExporter {
+public:
+	XDMFExporter(const std::string& name, const ExporterOptions&, const mfem::FiniteElementSpace&, Fields&);
+
+	XDMFExporter(const XDMFExporter&) = delete;
+	XDMFExporter(XDMFExporter&&) = default;
+	XDMFExporter& operator=(const XDMFExporter&) = delete;
+	XDMFExporter& operator=(XDMFExporter&&) = default;
+
+	void save(double time);
+
+	const std::string& getXDMFFilename() const { return xdmfFilename_; }
+	const std::string& getBinaryFilename() const { return binFilename_; }
+
+private:
+	struct RegisteredField {
+		std::string name;
+		const mfem::GridFunction* field;
+	};
+
+	std::string xdmfFilename_, binFilename_;
+	std::ofstream bin_, index_;
+	// Position of the closing tags of the index, where the next grid is written.
+	std::streamoff indexEnd_{ 0 };
+
+	ExporterOptions opts_;
+	const mfem::FiniteElementSpace& fes_;
+	std::vector<RegisteredField> fields_;
+
+	std::unique_ptr<mfem::SparseMatrix> interpolator_;
+	std::string topologyType_;
+	int numberOfPoints_{ 0 }, numberOfCells_{ 0 }, verticesPerCell_{ 0 };
+	std::streamoff geometryOffset_{ 0 }, topologyOffset_{ 0 };
+
+	mfem::Vector buffer_;
+	std::vector<float> singleBuffer_;
+
+	int getFieldPrecision() const { return opts_.singlePrecision ? sizeof(float) : sizeof(double); }
+	std::vector<int> buildExportedElements() const;
+	void registerFields(Fields&);
+	void writeMesh();
+	void writeIndexHeader();
+	void appendToIndex(double time, std::streamoff offset);
+	void writeIndexClosingTags();
+};
+
+}
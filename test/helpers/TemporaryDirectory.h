@@ -0,0 +1,47 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace maxwell {
+namespace fixtures {
+
+/** Directory created under the system temporary path for the files a test
+	writes. It is removed with all its contents on destruction, so tests do
+	not leave files in the working directory.
+	*/
+class TemporaryDirectory {
+public:
+	explicit TemporaryDirectory(const std::string& prefix = "maxwell_test")
+	{
+		std::mt19937_64 random{ std::random_device{}() ^ (std::uint64_t) std::chrono::steady_clock::now().time_since_epoch().count() };
+		for (int attempt = 0; attempt < 16; attempt++) {
+			auto candidate{ std::filesystem::temp_directory_path() / (prefix + "_" + std::to_string(random())) };
+			if (std::filesystem::create_directory(candidate)) {
+				path_ = candidate;
+				return;
+			}
+		}
+		throw std::runtime_error("Could not create a temporary directory for " + prefix);
+	}
+	TemporaryDirectory(const TemporaryDirectory&) = delete;
+	TemporaryDirectory& operator=(const TemporaryDirectory&) = delete;
+
+	~TemporaryDirectory()
+	{
+		std::error_code ec;
+		std::filesystem::remove_all(path_, ec);
+	}
+
+	std::string path() const { return path_.string(); }
+	std::string file(const std::string& name) const { return (path_ / name).string(); }
+
+private:
+	std::filesystem::path path_;
+};
+
+}
+}
@@ -0,0 +1,12 @@
+#include "gtest/gtest.h"
+
+#include <mfem.hpp>
+
+// MPI tests need MPI and hypre to be initialized before any test runs.
+int main(int argc, char** argv)
+{
+	mfem::Mpi::Init(argc, argv);
+	mfem::Hypre::Init();
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -29,4 +29,27 @@ TEST_F(TestMaterial, invalidEpsOrMu)
 	EXPECT_ANY_THROW(Material( 20.0,  -1.0));
 	EXPECT_ANY_THROW(Material(-20.0,   1.0));
 	EXPECT_ANY_THROW(Material(-10.0, -10.0));
-}
\ No newline at end of file
+}
+
+TEST_F(TestMaterial, dispersivePoles)
+{
+	Material mat(2.0, 1.0);
+	EXPECT_FALSE(mat.isDispersive());
+
+	mat.addDebyePole({ 1.0, 1e-2 }).addLorentzPole({ 2.0, 5.0, 0.1 });
+	EXPECT_TRUE(mat.isDispersive());
+	EXPECT_EQ(1, mat.getDebyePoles().size());
+	EXPECT_EQ(1, mat.getLorentzPoles().size());
+	EXPECT_EQ(2.0, mat.getPermittivity());
+
+	EXPECT_ANY_THROW(mat.addDebyePole({ -1.0, 1e-2 }));
+	EXPECT_ANY_THROW(mat.addDrudePole({ 0.0, 1.0 }));
+	EXPECT_ANY_THROW(mat.addLorentzPole({ 1.0, 1.0, -1.0 }));
+}
+
+TEST_F(TestMaterial, conductivity)
+{
+	EXPECT_EQ(0.0, Material(1.0, 1.0).getConductivity());
+	EXPECT_EQ(0.5, Material(1.0, 1.0, 0.5).getConductivity());
+	EXPECT_ANY_THROW(Material(1.0, 1.0, -0.5));
+}
@@ -0,0 +1,255 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+#include "SourceFixtures.h"
+#include "maxwell/Solver.h"
+#include "maxwell/ParSolver.h"
+
+using namespace maxwell;
+using namespace mfem;
+using namespace fixtures::sources;
+
+class TestParSolver : public ::testing::Test {
+protected:
+	Model buildModel(int nx, int ny, const BdrCond& bdr = BdrCond::PEC)
+	{
+		return Model(
+			Mesh::MakeCartesian2D(nx, ny, Element::Type::QUADRILATERAL),
+			AttributeToMaterial{},
+			AttributeToBoundary{ {1, bdr}, {2, bdr}, {3, bdr}, {4, bdr} }
+		);
+	}
+
+	Probes buildPointsProbes()
+	{
+		return { { PointsProbe{ E, Z, Points{ {0.3, 0.4}, {0.71, 0.52}, {0.5, 0.5} } } } };
+	}
+
+	static int getRank()
+	{
+		int res;
+		MPI_Comm_rank(MPI_COMM_WORLD, &res);
+		return res;
+	}
+};
+
+TEST_F(TestParSolver, pointsProbesMatchSerialSolver)
+{
+	for (const auto& opts : { SolverOptions{}.setFinalTime(0.2), SolverOptions{}.setFinalTime(0.2).setCentered() }) {
+		ParSolver parallel{
+			MPI_COMM_WORLD,
+			buildModel(8, 8),
+			buildPointsProbes(),
+			buildGaussianInitialField(E, Z, 0.1, 1.0, mfem::Vector({ 0.5, 0.5 })),
+			opts
+		};
+		parallel.run();
+		if (getRank() != 0) {
+			continue;
+		}
+
+		maxwell::Solver serial{
+			buildModel(8, 8),
+			buildPointsProbes(),
+			buildGaussianInitialField(E, Z, 0.1, 1.0, mfem::Vector({ 0.5, 0.5 })),
+			opts
+		};
+		serial.run();
+
+		const auto& expected{ serial.getPointsProbe(0).getFieldMovie() };
+		const auto& movie{ parallel.getPointsProbe(0).getFieldMovie() };
+		ASSERT_EQ(expected.size(), movie.size());
+		auto it{ movie.begin() };
+		for (const auto& frame : expected) {
+			EXPECT_NEAR(frame.first, it->first, 1e-12);
+			for (std::size_t i{ 0 }; i < frame.second.size(); i++) {
+				EXPECT_NEAR(frame.second[i], it->second[i], 1e-10);
+			}
+			it++;
+		}
+	}
+}
+
+TEST_F(TestParSolver, unsupportedProblemsThrow)
+{
+	Probes energy;
+	energy.energyProbes.push_back(EnergyProbe{});
+	EXPECT_ANY_THROW(ParSolver(MPI_COMM_WORLD, buildModel(4, 4), energy, buildGaussianInitialField(E, Z, 0.1, 1.0, mfem::Vector({ 0.5, 0.5 }))));
+	EXPECT_ANY_THROW(ParSolver(MPI_COMM_WORLD, buildModel(4, 4), Probes{ { PointsProbe{ E, Z, Points{ {2.0, 2.0} } } } }, buildGaussianInitialField(E, Z, 0.1, 1.0, mfem::Vector({ 0.5, 0.5 }))));
+}
+
+TEST_F(TestParSolver, exporterProbeWritesOnePiecePerRank)
+{
+	const std::string name{ "ParSolverTestExporter" };
+	const std::filesystem::path collection{ std::filesystem::path("ParaView") / name };
+	Probes probes;
+	probes.exporterProbes = { ExporterProbe{ name } };
+	probes.visSteps = 1;
+
+	int size;
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+	{
+		ParSolver solver{
+			MPI_COMM_WORLD,
+			buildModel(8, 8),
+			probes,
+			buildGaussianInitialField(E, Z, 0.1, 1.0, mfem::Vector({ 0.5, 0.5 })),
+			SolverOptions{}.setTimeStep(1e-3).setFinalTime(2e-3)
+		};
+		solver.run();
+	}
+	MPI_Barrier(MPI_COMM_WORLD);
+
+	if (getRank() == 0) {
+		auto readFile = [](const std::filesystem::path& path) {
+			std::ifstream in{ path };
+			return std::string{ std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+		};
+		auto countOccurrences = [](const std::string& text, const std::string& pattern) {
+			std::size_t res{ 0 };
+			for (auto pos{ text.find(pattern) }; pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+				res++;
+			}
+			return res;
+		};
+
+		int cycles{ 0 };
+		for (const auto& entry : std::filesystem::directory_iterator(collection)) {
+			if (!entry.is_directory()) {
+				continue;
+			}
+			cycles++;
+			// Rank 0 ties the pieces written by every rank.
+			EXPECT_EQ(size, (int) countOccurrences(readFile(entry.path() / "data.pvtu"), "<Piece "));
+			for (int r = 0; r < size; r++) {
+				std::stringstream piece;
+				piece << "proc" << std::setw(6) << std::setfill('0') << r << ".vtu";
+				EXPECT_TRUE(std::filesystem::exists(entry.path() / piece.str()));
+			}
+		}
+		EXPECT_LT(1, cycles);
+		EXPECT_EQ(cycles, (int) countOccurrences(readFile(collection / (name + ".pvd")), "<DataSet "));
+
+		std::filesystem::remove_all(collection);
+	}
+	MPI_Barrier(MPI_COMM_WORLD);
+}
+
+TEST_F(TestParSolver, haloExchange_neighbourDofsOnlyWithSeveralRanks)
+{
+	auto model{ buildModel(8, 8) };
+	ParMesh mesh{ MPI_COMM_WORLD, model.getMesh() };
+	DG_FECollection fec{ 2, 2, BasisType::GaussLobatto };
+	ParFiniteElementSpace fes{ &mesh, &fec };
+	ParMaxwellEvolution evolution{ fes, model, MaxwellEvolOptions{} };
+
+	int size;
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+	EXPECT_EQ(size > 1, evolution.getNumberOfNeighbourDofs() > 0);
+
+	Vector in(evolution.Height()), out(evolution.Height());
+	in.Randomize(getRank());
+	evolution.Mult(in, out);
+	EXPECT_TRUE(out.CheckFinite() == 0);
+}
+
+TEST_F(TestParSolver, splitOperatorsMatchParallelAssembledProduct)
+{
+	auto model{ buildModel(8, 8) };
+	ParMesh mesh{ MPI_COMM_WORLD, model.getMesh() };
+	DG_FECollection fec{ 2, 2, BasisType::GaussLobatto };
+	ParFiniteElementSpace fes{ &mesh, &fec };
+	fes.ExchangeFaceNbrData();
+
+	std::vector<FiniteElementOperator> forms;
+	forms.push_back(buildDerivativeOperator(X, fes));
+	forms.push_back(buildFluxOperator(E, { X }, model, fes));
+	forms.push_back(buildPenaltyOperator(H, {}, model, fes, MaxwellEvolOptions{}));
+	const auto MInv{ buildInverseMassMatrix(H, model, fes) };
+	std::unique_ptr<HypreParMatrix> m{ dynamic_cast<ParBilinearForm&>(*MInv).ParallelAssemble() };
+
+	ParGridFunction x{ &fes };
+	x.Randomize(getRank() + 1);
+	x.ExchangeFaceNbrData();
+	for (const auto& A : forms) {
+		// Unsplit reference, with the columns of other ranks handled by hypre.
+		std::unique_ptr<HypreParMatrix> a{ dynamic_cast<ParBilinearForm&>(*A).ParallelAssemble() };
+		std::unique_ptr<HypreParMatrix> full{ ParMult(m.get(), a.get(), true) };
+		Vector expected(fes.GetNDofs());
+		full->Mult(x, expected);
+
+		const auto op{ ParMaxwellEvolution::buildSplitByMult(*MInv, *A, fes.GetNDofs(), MemoryPlacementOptions{}) };
+		Vector split(fes.GetNDofs());
+		op.interior->Mult(x, split);
+		op.boundary->AddMult(x.FaceNbrData(), split);
+
+		split -= expected;
+		EXPECT_NEAR(0.0, split.Normlinf(), 1e-10 * std::max(1.0, expected.Normlinf()));
+	}
+}
+
+TEST_F(TestParSolver, evolutionMultMatchesSerialEvolution)
+{
+	int size;
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+	auto cube{ Mesh::MakeCartesian3D(4, 4, 4, Element::Type::HEXAHEDRON) };
+	Model model{
+		cube,
+		AttributeToMaterial{},
+		AttributeToBoundary{ {1, BdrCond::PEC}, {2, BdrCond::PEC}, {3, BdrCond::PEC}, {4, BdrCond::PEC}, {5, BdrCond::SMA}, {6, BdrCond::SMA} }
+	};
+	auto& serialMesh{ model.getMesh() };
+	std::unique_ptr<int[]> partitioning{ serialMesh.GeneratePartitioning(size) };
+	ParMesh mesh{ MPI_COMM_WORLD, serialMesh, partitioning.get() };
+
+	DG_FECollection fec{ 2, 3, BasisType::GaussLobatto };
+	FiniteElementSpace serialFes{ &serialMesh, &fec };
+	ParFiniteElementSpace fes{ &mesh, &fec };
+	MaxwellEvolOptions opts;
+	MaxwellEvolution3D serial{ serialFes, model, opts };
+	ParMaxwellEvolution parallel{ fes, model, opts };
+
+	// Local elements keep the order of the serial elements of this rank.
+	std::vector<std::pair<int, int>> serialToLocal;
+	Array<int> serialDofs, localDofs;
+	for (int e = 0, l = 0; e < serialMesh.GetNE(); e++) {
+		if (partitioning[e] != getRank()) {
+			continue;
+		}
+		serialFes.GetElementDofs(e, serialDofs);
+		fes.GetElementDofs(l++, localDofs);
+		for (int i = 0; i < serialDofs.Size(); i++) {
+			serialToLocal.emplace_back(serialDofs[i], localDofs[i]);
+		}
+	}
+	ASSERT_EQ(fes.GetNDofs(), (int) serialToLocal.size());
+
+	Vector xSerial(serial.Width()), ySerial(serial.Height());
+	xSerial.Randomize(1);
+	serial.Mult(xSerial, ySerial);
+
+	const auto serialNDofs{ serialFes.GetNDofs() }, localNDofs{ fes.GetNDofs() };
+	Vector x(parallel.Width()), y(parallel.Height());
+	for (int c = 0; c < 6; c++) {
+		for (const auto& dofs : serialToLocal) {
+			x[c * localNDofs + dofs.second] = xSerial[c * serialNDofs + dofs.first];
+		}
+	}
+	parallel.Mult(x, y);
+
+	double error{ 0.0 };
+	for (int c = 0; c < 6; c++) {
+		for (const auto& dofs : serialToLocal) {
+			error = std::max(error, std::abs(y[c * localNDofs + dofs.second] - ySerial[c * serialNDofs + dofs.first]));
+		}
+	}
+	EXPECT_NEAR(0.0, error, 1e-10 * ySerial.Normlinf());
+}
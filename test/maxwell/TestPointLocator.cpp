@@ -0,0 +1,85 @@
+#include "gtest/gtest.h"
+
+#include <cmath>
+
+#include "maxwell/PointLocator.h"
+
+using namespace maxwell;
+using namespace mfem;
+
+class TestPointLocator : public ::testing::Test {
+};
+
+TEST_F(TestPointLocator, pointsInsideElements)
+{
+	Mesh mesh{ Mesh::MakeCartesian2D(4, 4, Element::Type::QUADRILATERAL, false, 1.0, 1.0, false) };
+	PointLocator locator{ mesh };
+
+	auto locations{ locator.locate({ {0.125, 0.125}, {0.875, 0.875} }) };
+
+	ASSERT_EQ(2, locations.size());
+	EXPECT_EQ(0, locations[0].elementId);
+	EXPECT_EQ(15, locations[1].elementId);
+	EXPECT_NEAR(0.5, locations[0].iP.x, 1e-8);
+	EXPECT_NEAR(0.5, locations[0].iP.y, 1e-8);
+}
+
+TEST_F(TestPointLocator, pointsOnSharedFacesAreDeterministic)
+{
+	Mesh mesh{ Mesh::MakeCartesian3D(3, 3, 3, Element::Type::TETRAHEDRON) };
+	PointLocator locator{ mesh };
+
+	Points points{ {1.0 / 3.0, 1.0 / 3.0, 1.0 / 3.0}, {0.5, 0.5, 0.5}, {0.0, 0.0, 0.0} };
+	auto locations{ locator.locate(points) };
+
+	for (std::size_t i{ 0 }; i < points.size(); i++) {
+		Vector pos;
+		mesh.GetElementTransformation(locations[i].elementId)->Transform(locations[i].iP, pos);
+		for (int d = 0; d < 3; d++) {
+			EXPECT_NEAR(points[i][d], pos[d], 1e-8);
+		}
+	}
+	EXPECT_EQ(locations[0].elementId, locator.locate({ points[0] })[0].elementId);
+}
+
+TEST_F(TestPointLocator, pointOutsideMeshThrows)
+{
+	Mesh mesh{ Mesh::MakeCartesian1D(10, 1.0) };
+	PointLocator locator{ mesh };
+
+	EXPECT_ANY_THROW(locator.locate({ {1.5} }));
+	EXPECT_NO_THROW(locator.locate({ {0.0}, {0.35}, {1.0} }));
+}
+
+static void warp(const Vector& x, Vector& y)
+{
+	y = x;
+	y[0] += 0.05 * std::sin(2.0 * std::acos(-1.0) * x[1]);
+}
+
+TEST_F(TestPointLocator, pointsInCurvedElements)
+{
+	Mesh mesh{ Mesh::MakeCartesian2D(6, 6, Element::Type::QUADRILATERAL) };
+	mesh.SetCurvature(3);
+	mesh.Transform(warp);
+	PointLocator locator{ mesh };
+
+	Points points;
+	for (int i = 1; i < 20; i++) {
+		for (int j = 1; j < 20; j++) {
+			Vector x({ i / 20.0, j / 20.0 }), y;
+			warp(x, y);
+			points.push_back({ y[0], y[1] });
+		}
+	}
+	const auto locations{ locator.locate(points) };
+
+	IsoparametricTransformation T;
+	for (std::size_t i{ 0 }; i < points.size(); i++) {
+		Vector pos;
+		mesh.GetElementTransformation(locations[i].elementId, &T);
+		T.Transform(locations[i].iP, pos);
+		EXPECT_NEAR(points[i][0], pos[0], 1e-8);
+		EXPECT_NEAR(points[i][1], pos[1], 1e-8);
+	}
+}
@@ -18,4 +18,24 @@ TEST_F(TestProbes, integPointEmptySubvectors)
 {
 	auto pointVec = std::vector<std::vector<double>>({ {},{} });
 	ASSERT_ANY_THROW(PointsProbe(E, X, pointVec));
-}
\ No newline at end of file
+}
+
+TEST_F(TestProbes, dftProbeInvalidFrequencies)
+{
+	ASSERT_ANY_THROW(DFTProbe(E, X, Points{ {0.5} }, Frequencies{}));
+	ASSERT_ANY_THROW(DFTProbe(E, X, Points{ {0.5} }, Frequencies{ -1.0 }));
+	ASSERT_ANY_THROW(FieldDFTProbe(E, X, Frequencies{}));
+}
+
+TEST_F(TestProbes, gridProbeLattice)
+{
+	auto probe{ GridProbe::plane(E, Z, {0.0, 0.0}, {1.0, 0.0}, {0.0, 0.5}, 3, 2) };
+	auto points{ probe.buildPoints() };
+
+	ASSERT_EQ(6, points.size());
+	EXPECT_EQ(Point({ 0.5, 0.0 }), points[1]);
+	EXPECT_EQ(Point({ 1.0, 0.5 }), points[5]);
+
+	ASSERT_ANY_THROW(GridProbe(E, X, {0.0}, {{1.0}}, {0}));
+	ASSERT_ANY_THROW(GridProbe(E, X, {0.0}, {{1.0, 0.0}}, {2}));
+}
@@ -1,5 +1,9 @@
 #include "gtest/gtest.h"
 #include "SourceFixtures.h"
+#include "TemporaryDirectory.h"
+
+#include <fstream>
+#include <iterator>
 
 #include "maxwell/ProbesManager.h"
 #include "maxwell/SourcesManager.h"
@@ -9,7 +13,21 @@ using namespace mfem;
 using namespace fixtures::sources;
 
 class TestProbesManager : public ::testing::Test {
-	
+protected:
+	static std::string readFile(const std::string& filename)
+	{
+		std::ifstream in{ filename, std::ios::binary };
+		return { std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+	}
+
+	static std::size_t countOccurrences(const std::string& text, const std::string& pattern)
+	{
+		std::size_t res{ 0 };
+		for (auto pos{ text.find(pattern) }; pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+			res++;
+		}
+		return res;
+	}
 };
 
 TEST_F(TestProbesManager, exporterProbe)
@@ -28,3 +46,323 @@ TEST_F(TestProbesManager, exporterProbe)
 
 	ASSERT_NO_THROW(pM.updateProbes(0.0));
 }
+
+TEST_F(TestProbesManager, xdmfExporterProbe)
+{
+	Mesh mesh{ Mesh::MakeCartesian2D(5, 5, Element::Type::QUADRILATERAL) };
+	DG_FECollection fec{ 2, 2, BasisType::GaussLobatto };
+	FiniteElementSpace fes{ &mesh, &fec };
+	Fields fields{ fes };
+	SourcesManager sM{ buildGaussianInitialField(E, Z, 0.1, 1.0, Vector({0.5, 0.5})), fes };
+	sM.setFields3D(fields);
+
+	fixtures::TemporaryDirectory dir;
+	Probes ps;
+	ps.visSteps = 1;
+	ps.xdmfExporterProbes = { XDMFExporterProbe{ dir.file("ProbesManagerTestXDMF") } };
+
+	{
+		ProbesManager pM{ ps, fes, fields };
+		ASSERT_NO_THROW(pM.updateProbes(0.0));
+		ASSERT_NO_THROW(pM.updateProbes(0.1));
+	}
+
+	// 25 elements refined with the order of the space, 3x3 points and 2x2 cells each.
+	const std::size_t points{ 25 * 9 }, cells{ 25 * 4 }, components{ 6 };
+	const auto geometryBytes{ points * 3 * sizeof(double) };
+	const auto topologyBytes{ cells * 4 * sizeof(int) };
+	const auto snapshotBytes{ components * points * sizeof(double) };
+
+	// The mesh is only written once, followed by one block of fields per snapshot.
+	const auto bin{ readFile(dir.file("ProbesManagerTestXDMF.bin")) };
+	EXPECT_EQ(geometryBytes + topologyBytes + 2 * snapshotBytes, bin.size());
+
+	const auto xdmf{ readFile(dir.file("ProbesManagerTestXDMF.xdmf")) };
+	EXPECT_EQ(1u, countOccurrences(xdmf, "<Geometry Name="));
+	EXPECT_EQ(1u, countOccurrences(xdmf, "<Topology Name="));
+	EXPECT_EQ(2u, countOccurrences(xdmf, "<Time Value="));
+	EXPECT_EQ(2 * components, countOccurrences(xdmf, "<Attribute Name="));
+	// Grids are appended over the closing tags, which must end the index only once.
+	EXPECT_EQ(1u, countOccurrences(xdmf, "</Xdmf>"));
+	EXPECT_EQ(xdmf.size() - std::string("</Grid>\n</Domain>\n</Xdmf>\n").size(), xdmf.rfind("</Grid>\n</Domain>\n</Xdmf>\n"));
+	EXPECT_LT(xdmf.find("<Time Value=\"0\"/>"), xdmf.find("<Time Value=\"0.10000000000000001\"/>"));
+	EXPECT_NE(std::string::npos, xdmf.find("Seek=\"0\">ProbesManagerTestXDMF.bin"));
+	EXPECT_NE(std::string::npos, xdmf.find("Seek=\"" + std::to_string(geometryBytes) + "\""));
+	for (std::size_t s{ 0 }; s < 2; s++) {
+		const auto offset{ geometryBytes + topologyBytes + s * snapshotBytes };
+		EXPECT_NE(std::string::npos, xdmf.find("Seek=\"" + std::to_string(offset) + "\""));
+	}
+}
+
+TEST_F(TestProbesManager, xdmfExporterProbeSelectedRegion)
+{
+	Mesh mesh{ Mesh::MakeCartesian2D(5, 5, Element::Type::QUADRILATERAL) };
+	DG_FECollection fec{ 3, 2, BasisType::GaussLobatto };
+	FiniteElementSpace fes{ &mesh, &fec };
+	Fields fields{ fes };
+
+	ExporterOptions opts;
+	opts.components = { {E, Z} };
+	opts.boxMin = { 0.4, 0.4 };
+	opts.boxMax = { 0.6, 0.6 };
+	opts.levelsOfDetail = 1;
+	opts.singlePrecision = true;
+
+	fixtures::TemporaryDirectory dir;
+	Probes ps;
+	ps.xdmfExporterProbes = { XDMFExporterProbe{ dir.file("ProbesManagerTestXDMFRegion"), opts } };
+
+	{
+		ProbesManager pM{ ps, fes, fields };
+		ASSERT_NO_THROW(pM.updateProbes(0.0));
+	}
+
+	// Elements touching [0.4, 0.6]^2 are the 3x3 around the center, with 2x2 points each.
+	const std::size_t elements{ 9 }, points{ elements * 4 };
+	const auto xdmf{ readFile(dir.file("ProbesManagerTestXDMFRegion.xdmf")) };
+	EXPECT_NE(std::string::npos, xdmf.find("NumberOfElements=\"" + std::to_string(elements) + "\""));
+	EXPECT_NE(std::string::npos, xdmf.find("Dimensions=\"" + std::to_string(points) + " 3\""));
+	EXPECT_EQ(1u, countOccurrences(xdmf, "<Attribute Name=\"Ez\""));
+	EXPECT_EQ(1u, countOccurrences(xdmf, "<Attribute Name="));
+	EXPECT_NE(std::string::npos, xdmf.find("Precision=\"4\""));
+
+	const auto bin{ readFile(dir.file("ProbesManagerTestXDMFRegion.bin")) };
+	EXPECT_EQ(points * 3 * sizeof(double) + elements * 4 * sizeof(int) + points * sizeof(float), bin.size());
+}
+
+TEST_F(TestProbesManager, xdmfExporterProbeBoxOfWrongDimension)
+{
+	Mesh mesh{ Mesh::MakeCartesian2D(5, 5, Element::Type::QUADRILATERAL) };
+	DG_FECollection fec{ 1, 2, BasisType::GaussLobatto };
+	FiniteElementSpace fes{ &mesh, &fec };
+	Fields fields{ fes };
+
+	ExporterOptions opts;
+	opts.boxMin = { 0.4, 0.4 };
+	opts.boxMax = { 0.6 };
+
+	fixtures::TemporaryDirectory dir;
+	Probes ps;
+	ps.xdmfExporterProbes = { XDMFExporterProbe{ dir.file("ProbesManagerTestXDMFBox"), opts } };
+	EXPECT_THROW(ProbesManager(ps, fes, fields), std::runtime_error);
+}
+
+TEST_F(TestProbesManager, exporterProbeRegionNotSupported)
+{
+	Mesh mesh{ Mesh::MakeCartesian1D(20, 1.0) };
+	DG_FECollection fec{ 2, 1, BasisType::GaussLobatto };
+	FiniteElementSpace fes{ &mesh, &fec };
+	Fields fields{ fes };
+
+	ExporterOptions opts;
+	opts.attributes = { 1 };
+
+	Probes ps;
+	ps.exporterProbes = { ExporterProbe{"ProbesManagerTestRegion", opts} };
+
+	ASSERT_ANY_THROW(ProbesManager(ps, fes, fields));
+}
+
+TEST_F(TestProbesManager, gridProbeInterpolatesLinearField)
+{
+	Mesh mesh{ Mesh::MakeCartesian2D(4, 4, Element::Type::TRIANGLE) };
+	DG_FECollection fec{ 2, 2, BasisType::GaussLobatto };
+	FiniteElementSpace fes{ &mesh, &fec };
+	Fields fields{ fes };
+	FunctionCoefficient linear{ [](const Vector& x) { return x[0] + 2.0 * x[1]; } };
+	fields.E[Z].ProjectCoefficient(linear);
+
+	Probes ps;
+	ps.gridProbes = { GridProbe::line(E, Z, {0.1, 0.2}, {0.9, 0.7}, 11) };
+	ps.visSteps = 1;
+
+	ProbesManager pM{ ps, fes, fields };
+	pM.updateProbes(0.0);
+
+	const auto& probe{ pM.getGridProbe(0) };
+	const auto points{ probe.buildPoints() };
+	const auto& frame{ probe.getFieldMovie().at(0.0) };
+	ASSERT_EQ(points.size(), frame.size());
+	for (std::size_t i{ 0 }; i < points.size(); i++) {
+		EXPECT_NEAR(points[i][0] + 2.0 * points[i][1], frame[i], 1e-10);
+	}
+}
+
+TEST_F(TestProbesManager, energyAndPoyntingFluxOfConstantFields)
+{
+	Mesh mesh{ Mesh::MakeCartesian1D(10, 1.0) };
+	DG_FECollection fec{ 2, 1, BasisType::GaussLobatto };
+	FiniteElementSpace fes{ &mesh, &fec };
+	Fields fields{ fes };
+	fields.E1D = 1.0;
+	fields.H1D = 2.0;
+
+	Probes ps;
+	ps.energyProbes = { EnergyProbe{} };
+	ps.poyntingFluxProbes = { PoyntingFluxProbe{ {1} }, PoyntingFluxProbe{ {2} } };
+
+	AttributeToMaterial materials{ { 1, Material{ 2.0, 3.0 } } };
+	ProbesManager pM{ ps, fes, fields, materials };
+	pM.updateProbes(0.0);
+
+	const auto& energy{ pM.getEnergyProbe(0).getEnergyMovie().at(0.0) };
+	EXPECT_NEAR(0.5 * 2.0 * 1.0, energy.electric, 1e-12);
+	EXPECT_NEAR(0.5 * 3.0 * 4.0, energy.magnetic, 1e-12);
+
+	EXPECT_NEAR(-2.0, pM.getPoyntingFluxProbe(0).getFluxMovie().at(0.0), 1e-12);
+	EXPECT_NEAR( 2.0, pM.getPoyntingFluxProbe(1).getFluxMovie().at(0.0), 1e-12);
+}
+
+TEST_F(TestProbesManager, energyOfLinearFieldIsExact)
+{
+	Mesh mesh{ Mesh::MakeCartesian1D(1, 1.0) };
+	DG_FECollection fec{ 1, 1, BasisType::GaussLobatto };
+	FiniteElementSpace fes{ &mesh, &fec };
+	Fields fields{ fes };
+	FunctionCoefficient x{ [](const Vector& pos) { return pos[0]; } };
+	fields.E1D.ProjectCoefficient(x);
+
+	Probes ps;
+	ps.energyProbes = { EnergyProbe{} };
+	ProbesManager pM{ ps, fes, fields };
+	pM.updateProbes(0.0);
+
+	// A lumped mass would give 1/4 instead of the integral of x^2 / 2.
+	EXPECT_NEAR(1.0 / 6.0, pM.getEnergyProbe(0).getEnergyMovie().at(0.0).electric, 1e-12);
+}
+
+TEST_F(TestProbesManager, poyntingFluxThroughInteriorInterface)
+{
+	const int ne{ 10 };
+	Mesh mesh{ 1, ne + 1, ne, 3 };
+	for (int i = 0; i <= ne; i++) {
+		mesh.AddVertex(i / (double) ne);
+	}
+	for (int i = 0; i < ne; i++) {
+		mesh.AddSegment(i, i + 1, i < ne / 2 ? 1 : 2);
+	}
+	mesh.AddBdrPoint(0, 1);
+	mesh.AddBdrPoint(ne, 2);
+	mesh.AddBdrPoint(ne / 2, 3);
+	mesh.FinalizeMesh();
+
+	DG_FECollection fec{ 2, 1, BasisType::GaussLobatto };
+	FiniteElementSpace fes{ &mesh, &fec };
+	Fields fields{ fes };
+	fields.E1D = 1.0;
+	fields.H1D = 2.0;
+
+	Probes ps;
+	ps.poyntingFluxProbes = { PoyntingFluxProbe{ {3}, 1 }, PoyntingFluxProbe{ {3}, 2 } };
+	ProbesManager pM{ ps, fes, fields };
+	pM.updateProbes(0.0);
+
+	EXPECT_NEAR( 2.0, pM.getPoyntingFluxProbe(0).getFluxMovie().at(0.0), 1e-12);
+	EXPECT_NEAR(-2.0, pM.getPoyntingFluxProbe(1).getFluxMovie().at(0.0), 1e-12);
+
+	Probes unoriented;
+	unoriented.poyntingFluxProbes = { PoyntingFluxProbe{ {3} } };
+	EXPECT_ANY_THROW(ProbesManager(unoriented, fes, fields));
+
+	Probes wrongSide;
+	wrongSide.poyntingFluxProbes = { PoyntingFluxProbe{ {3}, 4 } };
+	EXPECT_ANY_THROW(ProbesManager(wrongSide, fes, fields));
+}
+
+TEST_F(TestProbesManager, nearToFarFieldProbeRadiationVectors)
+{
+	Mesh mesh{ Mesh::MakeCartesian3D(2, 2, 2, Element::Type::HEXAHEDRON) };
+	DG_FECollection fec{ 1, 3, BasisType::GaussLobatto };
+	FiniteElementSpace fes{ &mesh, &fec };
+	Fields fields{ fes };
+	FunctionCoefficient x{ [](const Vector& pos) { return pos[0]; } };
+	fields.H[Z].ProjectCoefficient(x);
+
+	Probes ps;
+	ps.nearToFarFieldProbes = { 
+		NearToFarFieldProbe{ {1, 2, 3, 4, 5, 6}, Frequencies{ 0.0, 1.0 }, SphericalDirections{ {std::acos(0.0), 0.0} } } 
+	};
+
+	ProbesManager pM{ ps, fes, fields };
+	pM.updateTransforms(0.0);
+	pM.updateTransforms(1.0);
+
+	// At zero frequency N is the surface integral of n x H, which for
+	// H = x z is -y times the volume of the unit cube.
+	const auto& v{ pM.getNearToFarFieldProbe(0).getRadiationVectors()[0][0] };
+	EXPECT_NEAR( 0.0, std::abs(v.N[X]), 1e-12);
+	EXPECT_NEAR(-1.0, v.N[Y].real(), 1e-12);
+	EXPECT_NEAR( 0.0, std::abs(v.N[Z]), 1e-12);
+	for (const auto& c : v.L) {
+		EXPECT_NEAR(0.0, std::abs(c), 1e-12);
+	}
+
+	const auto farField{ pM.getNearToFarFieldProbe(0).getFarField(0, 0) };
+	EXPECT_NEAR(0.0, std::abs(farField.theta), 1e-12);
+	EXPECT_NEAR(0.0, std::abs(farField.phi), 1e-12);
+}
+
+TEST_F(TestProbesManager, nearToFarFieldProbeOnInteriorSurface)
+{
+	// Unit cube of 4x4x4 hexahedra whose central 2x2x2 block, of attribute 2,
+	// is enclosed by the interior faces of attribute 7.
+	const int n{ 4 };
+	auto vertex = [&](int i, int j, int k) { return i + (n + 1) * (j + (n + 1) * k); };
+	Mesh mesh{ 3, (n + 1) * (n + 1) * (n + 1), n * n * n, 24 };
+	for (int k = 0; k <= n; k++) {
+		for (int j = 0; j <= n; j++) {
+			for (int i = 0; i <= n; i++) {
+				mesh.AddVertex(i / (double) n, j / (double) n, k / (double) n);
+			}
+		}
+	}
+	for (int k = 0; k < n; k++) {
+		for (int j = 0; j < n; j++) {
+			for (int i = 0; i < n; i++) {
+				const int v[8]{
+					vertex(i, j, k), vertex(i + 1, j, k), vertex(i + 1, j + 1, k), vertex(i, j + 1, k),
+					vertex(i, j, k + 1), vertex(i + 1, j, k + 1), vertex(i + 1, j + 1, k + 1), vertex(i, j + 1, k + 1)
+				};
+				const auto isInside{ i > 0 && i < n - 1 && j > 0 && j < n - 1 && k > 0 && k < n - 1 };
+				mesh.AddHex(v, isInside ? 2 : 1);
+			}
+		}
+	}
+	for (int s : { 1, n - 1 }) {
+		for (int a = 1; a < n - 1; a++) {
+			for (int b = 1; b < n - 1; b++) {
+				const int x[4]{ vertex(s, a, b), vertex(s, a + 1, b), vertex(s, a + 1, b + 1), vertex(s, a, b + 1) };
+				const int y[4]{ vertex(a, s, b), vertex(a + 1, s, b), vertex(a + 1, s, b + 1), vertex(a, s, b + 1) };
+				const int z[4]{ vertex(a, b, s), vertex(a + 1, b, s), vertex(a + 1, b + 1, s), vertex(a, b + 1, s) };
+				mesh.AddBdrQuad(x, 7);
+				mesh.AddBdrQuad(y, 7);
+				mesh.AddBdrQuad(z, 7);
+			}
+		}
+	}
+	mesh.FinalizeMesh();
+
+	DG_FECollection fec{ 1, 3, BasisType::GaussLobatto };
+	FiniteElementSpace fes{ &mesh, &fec };
+	Fields fields{ fes };
+	FunctionCoefficient x{ [](const Vector& pos) { return pos[0]; } };
+	fields.H[Z].ProjectCoefficient(x);
+
+	const SphericalDirections directions{ {std::acos(0.0), 0.0} };
+	Probes ps;
+	ps.nearToFarFieldProbes = {
+		NearToFarFieldProbe{ {7}, Frequencies{ 0.0 }, directions, 2 },
+		NearToFarFieldProbe{ {7}, Frequencies{ 0.0 }, directions, 1 }
+	};
+	ProbesManager pM{ ps, fes, fields };
+	pM.updateTransforms(0.0);
+	pM.updateTransforms(1.0);
+
+	// N is -y times the enclosed volume, with the sign of the side normals point out of.
+	EXPECT_NEAR(-0.125, pM.getNearToFarFieldProbe(0).getRadiationVectors()[0][0].N[Y].real(), 1e-12);
+	EXPECT_NEAR( 0.125, pM.getNearToFarFieldProbe(1).getRadiationVectors()[0][0].N[Y].real(), 1e-12);
+
+	Probes unoriented;
+	unoriented.nearToFarFieldProbes = { NearToFarFieldProbe{ {7}, Frequencies{ 0.0 }, directions } };
+	EXPECT_ANY_THROW(ProbesManager(unoriented, fes, fields));
+}
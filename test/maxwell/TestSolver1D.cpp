@@ -1,6 +1,12 @@
+#include <cmath>
+#include <csignal>
+#include <fstream>
+#include <iterator>
+
 #include "gtest/gtest.h"
 #include "SourceFixtures.h"
 #include "GlobalFunctions.h"
+#include "TemporaryDirectory.h"
 
 #include "maxwell/Solver.h"
 
@@ -323,4 +329,532 @@ TEST_F(TestSolver1D, DISABLED_twoSourceWaveTwoMaterialsReflection_SMA_PEC)
 		        getBoundaryFieldValueAtTime(solver.getPointsProbe(0), 0.90, 0), 2e-3);
 	EXPECT_NEAR(getBoundaryFieldValueAtTime(solver.getPointsProbe(0), 0.0, 0) * reflectCoeff,
 		        getBoundaryFieldValueAtTime(solver.getPointsProbe(0), 1.10, 1), 2e-3);
-}
\ No newline at end of file
+}
+
+TEST_F(TestSolver1D, timeSampledPointsProbe_independentOfTimeStep)
+{
+	auto probes{ buildProbes(E, X) };
+	probes.samplingSchedule.period = 0.03;
+	probes.samplingSchedule.times = { 0.125 };
+
+	auto runWithTimeStep = [&](double dt) {
+		maxwell::Solver solver{
+			buildModel(),
+			probes,
+			buildGaussianInitialField(E, X, 0.1, 1.0, Vector({ 0.5 })),
+			SolverOptions{}
+				.setTimeStep(dt)
+				.setFinalTime(0.3)
+		};
+		solver.run();
+		return solver.getPointsProbe(0).getFieldMovie();
+	};
+
+	const auto movieA{ runWithTimeStep(1e-3) };
+	const auto movieB{ runWithTimeStep(7e-4) };
+
+	ASSERT_EQ(12, movieA.size());
+	ASSERT_EQ(movieA.size(), movieB.size());
+	for (auto itA{ movieA.begin() }, itB{ movieB.begin() }; itA != movieA.end(); ++itA, ++itB) {
+		EXPECT_NEAR(itA->first, itB->first, 1e-12);
+		for (std::size_t i{ 0 }; i < itA->second.size(); ++i) {
+			EXPECT_NEAR(itA->second[i], itB->second[i], 1e-4);
+		}
+	}
+}
+
+TEST_F(TestSolver1D, dftProbe_zeroFrequencyMatchesTimeIntegral)
+{
+	auto probes{ buildProbes(E, X) };
+	probes.visSteps = 1;
+	probes.dftProbes = { DFTProbe{ E, X, Points{ {0.0},{0.5},{1.0} }, Frequencies{ 0.0, 1.0 } } };
+	probes.fieldDFTProbes = { FieldDFTProbe{ E, X, Frequencies{ 0.0 } } };
+
+	const double dt{ 1e-3 };
+	maxwell::Solver solver{
+		buildModel(),
+		probes,
+		buildGaussianInitialField(E, X, 0.1, 1.0, Vector({ 0.5 })),
+		SolverOptions{}
+			.setTimeStep(dt)
+			.setFinalTime(0.2)
+	};
+	solver.run();
+
+	const auto& movie{ solver.getPointsProbe(0).getFieldMovie() };
+	const auto& transform{ solver.getDFTProbe(0).getTransform() };
+	for (std::size_t i{ 0 }; i < 3; ++i) {
+		double integral{ 0.0 };
+		for (auto it{ std::next(movie.begin()) }; it != movie.end(); ++it) {
+			integral += it->second[i] * dt;
+		}
+		EXPECT_NEAR(integral, transform[i][0].real(), 1e-8);
+		EXPECT_NEAR(0.0, transform[i][0].imag(), 1e-12);
+	}
+
+	const auto& fieldTransform{ solver.getFieldDFTProbe(0) };
+	EXPECT_EQ(1, fieldTransform.getReal().size());
+	EXPECT_EQ(solver.getFields().E1D.Size(), fieldTransform.getReal()[0].Size());
+}
+
+TEST_F(TestSolver1D, dftProbe_standingWaveAtItsFrequency)
+{
+	// The first mode of the PEC cavity, E = sin(pi x) cos(pi t), has frequency 1/2.
+	// Over whole periods its transform is sin(pi x) T / 2 at 1/2 and vanishes at 1.
+	Probes probes;
+	probes.dftProbes = { DFTProbe{ E, X, Points{ {0.25},{0.5} }, Frequencies{ 0.5, 1.0 } } };
+
+	const double finalTime{ 4.0 };
+	maxwell::Solver solver{
+		buildModel(),
+		probes,
+		buildSinusoidalInitialField(E, X, { 1, 0, 0 }, { 1.0, 1.0, 1.0 }),
+		SolverOptions{}
+			.setTimeStep(1e-3)
+			.setFinalTime(finalTime)
+	};
+	solver.run();
+
+	const auto& transform{ solver.getDFTProbe(0).getTransform() };
+	const std::vector<double> xs{ 0.25, 0.5 };
+	const auto pi{ std::acos(-1.0) };
+	for (std::size_t i{ 0 }; i < xs.size(); ++i) {
+		const auto expected{ std::sin(pi * xs[i]) * finalTime / 2.0 };
+		EXPECT_NEAR(expected, transform[i][0].real(), 1e-2 * expected);
+		EXPECT_NEAR(0.0, transform[i][0].imag(), 1e-2 * expected);
+		EXPECT_NEAR(0.0, std::abs(transform[i][1]), 1e-2 * expected);
+	}
+}
+
+TEST_F(TestSolver1D, energyProbe_conservedWithCenteredFluxAndPEC)
+{
+	Probes probes;
+	probes.energyProbes = { EnergyProbe{} };
+	probes.poyntingFluxProbes = { PoyntingFluxProbe{ {1, 2} } };
+	probes.visSteps = 20;
+
+	maxwell::Solver solver{
+		buildModel(),
+		probes,
+		buildGaussianInitialField(E, Y, 0.1, 1.0, Vector({ 0.5 })),
+		SolverOptions{}
+			.setTimeStep(2.5e-3)
+			.setFinalTime(1.0)
+			.setCentered()
+	};
+	solver.run();
+
+	const auto& movie{ solver.getEnergyProbe(0).getEnergyMovie() };
+	const auto initial{ movie.begin()->second.total() };
+	ASSERT_LT(0.0, initial);
+	for (const auto& frame : movie) {
+		EXPECT_NEAR(initial, frame.second.total(), 1e-3 * initial);
+	}
+	for (const auto& frame : solver.getPoyntingFluxProbe(0).getFluxMovie()) {
+		EXPECT_NEAR(0.0, frame.second, 1e-2 * initial);
+	}
+}
+
+TEST_F(TestSolver1D, checkpoint_restartMatchesUninterruptedRun)
+{
+	fixtures::TemporaryDirectory dir;
+	const auto checkpoint{ dir.file(getTestCaseName() + ".ckpt") };
+	const auto opts{ 
+		SolverOptions{}
+			.setTimeStep(2.5e-3)
+			.setFinalTime(0.5)
+			.setCheckpoint(checkpoint, 0.25) 
+	};
+
+	maxwell::Solver reference{
+		buildModel(),
+		buildProbes(E, Y),
+		buildGaussianInitialField(E, Y),
+		SolverOptions{ opts }.setFinalTime(1.0)
+	};
+	reference.run();
+
+	{
+		maxwell::Solver first{
+			buildModel(),
+			buildProbes(E, Y),
+			buildGaussianInitialField(E, Y),
+			opts
+		};
+		first.run();
+	}
+
+	maxwell::Solver restarted{
+		buildModel(),
+		buildProbes(E, Y),
+		buildGaussianInitialField(E, Y),
+		SolverOptions{ opts }.setFinalTime(1.0).setRestart(checkpoint)
+	};
+	EXPECT_NEAR(0.5, restarted.getTime(), 1e-9);
+	restarted.run();
+
+	Vector diff{ reference.getFields().allDOFs };
+	diff -= restarted.getFields().allDOFs;
+	EXPECT_NEAR(0.0, diff.Normlinf(), 1e-12);
+	EXPECT_EQ(
+		reference.getPointsProbe(0).getFieldMovie().size(),
+		restarted.getPointsProbe(0).getFieldMovie().size()
+	);
+
+	EXPECT_ANY_THROW(
+		maxwell::Solver(
+			buildModel(),
+			buildProbes(E, Y),
+			buildGaussianInitialField(E, Y),
+			SolverOptions{ opts }.setOrder(3).setRestart(checkpoint)
+		)
+	);
+}
+
+extern "C" void ignoreSignalForTest(int) {}
+
+TEST_F(TestSolver1D, checkpoint_restoresPreviousSignalHandlers)
+{
+	fixtures::TemporaryDirectory dir;
+	const auto previous{ std::signal(SIGTERM, ignoreSignalForTest) };
+	{
+		maxwell::Solver solver{
+			buildModel(),
+			Probes{},
+			buildGaussianInitialField(E, Y),
+			SolverOptions{}.setCheckpoint(dir.file(getTestCaseName() + ".ckpt"), 0.0, true)
+		};
+		const auto installed{ std::signal(SIGTERM, SIG_IGN) };
+		std::signal(SIGTERM, installed);
+		EXPECT_NE(&ignoreSignalForTest, installed);
+	}
+	EXPECT_EQ(&ignoreSignalForTest, std::signal(SIGTERM, previous));
+}
+
+TEST_F(TestSolver1D, drudeMaterial_auxiliaryCurrents)
+{
+	const double epsInf{ 2.0 }, wp{ 3.0 }, gamma{ 0.5 };
+	maxwell::Solver solver{
+		Model(
+			Mesh::MakeCartesian1D(10, 1.0), 
+			AttributeToMaterial{ {1, Material{ epsInf, 1.0 }.addDrudePole({ wp, gamma })} }, 
+			buildAttrToBdrMap1D(BdrCond::PEC, BdrCond::PEC)
+		),
+		Probes{},
+		buildGaussianInitialField(E, Y),
+		SolverOptions{}
+	};
+
+	const auto& evol{ *solver.getFEEvol() };
+	const auto ndofs{ solver.getFields().E1D.Size() };
+	ASSERT_EQ(3 * ndofs, evol.Width());
+
+	Vector x{ evol.Width() }, y0{ evol.Width() }, y1{ evol.Width() };
+	x = 0.0;
+	for (int i = 0; i < ndofs; i++) {
+		x[i] = 1.0;
+	}
+	evol.Mult(x, y0);
+	for (int i = 2 * ndofs; i < 3 * ndofs; i++) {
+		EXPECT_NEAR(wp * wp, y0[i], 1e-12);
+		x[i] = 1.0;
+	}
+	evol.Mult(x, y1);
+	for (int i = 0; i < ndofs; i++) {
+		EXPECT_NEAR(-1.0 / epsInf, y1[i] - y0[i], 1e-12);
+	}
+	for (int i = 2 * ndofs; i < 3 * ndofs; i++) {
+		EXPECT_NEAR(-gamma, y1[i] - y0[i], 1e-12);
+	}
+}
+
+TEST_F(TestSolver1D, conductiveMaterial_lossTerm)
+{
+	const double eps{ 2.0 }, sigma{ 0.5 };
+	auto buildSolver = [&](double conductivity) {
+		return std::make_unique<maxwell::Solver>(
+			Model(
+				Mesh::MakeCartesian1D(10, 1.0),
+				AttributeToMaterial{ {1, Material{ eps, 1.0, conductivity }} },
+				buildAttrToBdrMap1D(BdrCond::PEC, BdrCond::PEC)
+			),
+			Probes{},
+			buildGaussianInitialField(E, Y),
+			SolverOptions{}
+		);
+	};
+	const auto lossless{ buildSolver(0.0) };
+	const auto lossy{ buildSolver(sigma) };
+	ASSERT_EQ(lossless->getFEEvol()->Width(), lossy->getFEEvol()->Width());
+
+	Vector x{ lossy->getFEEvol()->Width() }, y0{ x.Size() }, y1{ x.Size() };
+	x.Randomize(1);
+	lossless->getFEEvol()->Mult(x, y0);
+	lossy->getFEEvol()->Mult(x, y1);
+
+	const auto ndofs{ lossy->getFields().E1D.Size() };
+	for (int i = 0; i < ndofs; i++) {
+		EXPECT_NEAR(-sigma / eps * x[i], y1[i] - y0[i], 1e-12);
+	}
+	for (int i = ndofs; i < 2 * ndofs; i++) {
+		EXPECT_NEAR(0.0, y1[i] - y0[i], 1e-12);
+	}
+}
+
+TEST_F(TestSolver1D, totalFieldScatteredField_planewave)
+{
+	// Interior points at x = 0.3 and x = 0.7 enclose the total field region.
+	const int ne{ 100 };
+	Mesh mesh{ 1, ne + 1, ne, 4 };
+	for (int i = 0; i <= ne; i++) {
+		mesh.AddVertex(i / (double) ne);
+	}
+	for (int i = 0; i < ne; i++) {
+		mesh.AddSegment(i, i + 1);
+	}
+	mesh.AddBdrPoint(0, 1);
+	mesh.AddBdrPoint(ne, 2);
+	mesh.AddBdrPoint(30, 3);
+	mesh.AddBdrPoint(70, 3);
+	mesh.FinalizeMesh();
+
+	Probes probes{ { PointsProbe{ E, Y, Points{ {0.1}, {0.5}, {0.9} } } } };
+	probes.visSteps = 1;
+
+	Sources sources;
+	sources.push_back(std::make_unique<Planewave>(
+		Vector({ 0.0, 1.0, 0.0 }), Vector({ 1.0, 0.0, 0.0 }), GaussianPulse{ 0.05, 0.5 }, std::vector<Attribute>{ 3 }
+	));
+
+	maxwell::Solver solver{
+		Model(mesh, AttributeToMaterial{}, AttributeToBoundary{ {1, BdrCond::SMA}, {2, BdrCond::SMA} }),
+		probes,
+		sources,
+		SolverOptions{}.setFinalTime(1.5)
+	};
+	solver.run();
+
+	// The pulse peaks at x = 0.5 when t = 1.0 and does not leak out of the total field region.
+	double scatteredMax{ 0.0 }, totalMax{ 0.0 };
+	for (const auto& frame : solver.getPointsProbe(0).getFieldMovie()) {
+		scatteredMax = std::max({ scatteredMax, std::abs(frame.second[0]), std::abs(frame.second[2]) });
+		totalMax = std::max(totalMax, frame.second[1]);
+	}
+	EXPECT_NEAR(1.0, totalMax, 1e-2);
+	EXPECT_GT(1e-2, scatteredMax);
+}
+
+TEST_F(TestSolver1D, separableSource_currentDensityTerm)
+{
+	const double eps{ 2.0 };
+	const GaussianInitialField profile{ E, Y, 0.1, 1.0, Vector({ 0.5 }) };
+	const GaussianPulse waveform{ 1.0, 0.5 };
+	auto buildSolver = [&](const Sources& sources) {
+		return std::make_unique<maxwell::Solver>(
+			Model(
+				Mesh::MakeCartesian1D(10, 1.0),
+				AttributeToMaterial{ {1, Material{ eps, 1.0 }} },
+				buildAttrToBdrMap1D(BdrCond::PEC, BdrCond::PEC)
+			),
+			Probes{},
+			sources,
+			SolverOptions{}
+		);
+	};
+
+	Sources current;
+	current.push_back(std::make_unique<SeparableSource>(profile, waveform));
+	const auto driven{ buildSolver(current) };
+
+	Sources initial;
+	initial.push_back(profile.clone());
+	const auto reference{ buildSolver(initial) };
+	const auto& projected{ reference->getFields().E1D };
+
+	const auto& evol{ *driven->getFEEvol() };
+	Vector x{ evol.Width() }, y{ evol.Width() };
+	x = 0.0;
+	evol.Mult(x, y);
+
+	const auto ndofs{ projected.Size() };
+	for (int i = 0; i < ndofs; i++) {
+		EXPECT_NEAR(-waveform.eval(0.0) * projected[i] / eps, y[i], 1e-10);
+		EXPECT_EQ(0.0, y[ndofs + i]);
+	}
+	for (int i = 0; i < ndofs; i++) {
+		EXPECT_EQ(0.0, driven->getFields().E1D[i]);
+	}
+}
+
+TEST_F(TestSolver1D, pointDipole_softCurrentMoments)
+{
+	const double x0{ 0.53 }, moment{ 2.0 };
+	const GaussianPulse waveform{ 1.0, 0.5 };
+	Sources sources;
+	sources.push_back(std::make_unique<PointDipole>(E, Y, Vector({ x0 }), waveform, moment));
+	maxwell::Solver solver{ buildModel(10), Probes{}, sources, SolverOptions{} };
+
+	const auto& evol{ *solver.getFEEvol() };
+	Vector x{ evol.Width() }, y{ evol.Width() };
+	x = 0.0;
+	evol.Mult(x, y);
+
+	// Moments of the field derivative are the ones of the delta current.
+	Mesh mesh{ Mesh::MakeCartesian1D(10, 1.0) };
+	DG_FECollection fec{ SolverOptions{}.order, 1, BasisType::GaussLobatto };
+	FiniteElementSpace fes{ &mesh, &fec };
+	BilinearForm mass{ &fes };
+	mass.AddDomainIntegrator(new MassIntegrator);
+	mass.Assemble();
+	mass.Finalize();
+
+	GridFunction one{ &fes }, position{ &fes };
+	one = 1.0;
+	FunctionCoefficient positionCoefficient{ [](const Vector& p) { return p[0]; } };
+	position.ProjectCoefficient(positionCoefficient);
+
+	Vector dE{ y.GetData(), fes.GetNDofs() };
+	const auto g{ waveform.eval(0.0) };
+	EXPECT_NEAR(-moment * g, mass.InnerProduct(one, dE), 1e-10);
+	EXPECT_NEAR(-moment * g * x0, mass.InnerProduct(position, dE), 1e-10);
+
+	int nonZeros{ 0 };
+	for (int i = 0; i < y.Size(); i++) {
+		nonZeros += y[i] != 0.0;
+	}
+	EXPECT_EQ(fes.GetFE(0)->GetDof(), nonZeros);
+}
+
+TEST_F(TestSolver1D, pointDipole_hardSourceSetsFieldAtPosition)
+{
+	const RampedSinusoid waveform{ 2.0, 0.5 };
+	Sources sources;
+	sources.push_back(std::make_unique<PointDipole>(E, Y, Vector({ 0.57 }), waveform, 1.0, PointSourceType::Hard));
+
+	Probes probes{ { PointsProbe{ E, Y, Points{ {0.57} } } } };
+	probes.visSteps = 1;
+
+	maxwell::Solver solver{ buildModel(20), probes, sources, SolverOptions{}.setFinalTime(1.0) };
+	solver.run();
+
+	const auto& movie{ solver.getPointsProbe(0).getFieldMovie() };
+	ASSERT_LT(100, movie.size());
+	for (const auto& frame : movie) {
+		EXPECT_NEAR(waveform.eval(frame.first), frame.second[0], 1e-8);
+	}
+
+	// Samples inside a step are interpolated, and forced too.
+	Probes scheduled{ { PointsProbe{ E, Y, Points{ {0.57} } } } };
+	scheduled.samplingSchedule.period = 0.0137;
+	maxwell::Solver sampled{ buildModel(20), scheduled, sources, SolverOptions{}.setFinalTime(1.0) };
+	sampled.run();
+
+	const auto& sampledMovie{ sampled.getPointsProbe(0).getFieldMovie() };
+	ASSERT_LT(50, sampledMovie.size());
+	for (const auto& frame : sampledMovie) {
+		EXPECT_NEAR(waveform.eval(frame.first), frame.second[0], 1e-8);
+	}
+}
+
+TEST_F(TestSolver1D, memoryPlacement_firstTouchKeepsResults)
+{
+	const auto opts{ SolverOptions{}.setTimeStep(2.5e-3).setFinalTime(0.5) };
+
+	maxwell::Solver reference{
+		buildModel(),
+		buildProbes(E, Y),
+		buildGaussianInitialField(E, Y),
+		opts
+	};
+	reference.run();
+
+	maxwell::Solver placed{
+		buildModel(),
+		buildProbes(E, Y),
+		buildGaussianInitialField(E, Y),
+		SolverOptions{ opts }.setMemoryPlacement(true, true)
+	};
+	placed.run();
+
+	Vector diff{ reference.getFields().allDOFs };
+	diff -= placed.getFields().allDOFs;
+	EXPECT_NEAR(0.0, diff.Normlinf(), 1e-12);
+
+	const auto report{ placed.getStatePagePlacement() };
+	EXPECT_LT(0u, report.pages);
+	std::size_t placedPages{ 0 };
+	for (const auto& kv : report.pagesPerNode) {
+		EXPECT_LE(0, kv.first);
+		placedPages += kv.second;
+	}
+	EXPECT_LE(placedPages, report.pages);
+}
+
+TEST_F(TestSolver1D, performanceReport_countsPhasesAndOperatorGroups)
+{
+	fixtures::TemporaryDirectory dir;
+	const auto reportFile{ dir.file("performanceReport_1D.json") };
+	maxwell::Solver solver{
+		buildModel(),
+		buildProbes(E, Y),
+		buildGaussianInitialField(E, Y),
+		SolverOptions{}.setTimeStep(2.5e-3).setFinalTime(0.1).setPerformanceReport(reportFile)
+	};
+	solver.run();
+
+	const auto report{ solver.getPerformanceReport() };
+	const auto& mult{ report.get(ProfiledRegion::Mult) };
+	EXPECT_LT(0u, mult.calls);
+	EXPECT_EQ(0u, mult.calls % 4);
+	EXPECT_EQ(1u, report.get(ProfiledRegion::Assembly).calls);
+	EXPECT_LT(0u, report.get(ProfiledRegion::Probes).calls);
+	EXPECT_EQ(0u, report.get(ProfiledRegion::Checkpoint).calls);
+
+	// Two operators of each group in the upwind 1D evolution, one per field.
+	EXPECT_EQ(2 * mult.calls, report.get(ProfiledRegion::MS).calls);
+	EXPECT_EQ(2 * mult.calls, report.get(ProfiledRegion::MFN).calls);
+	EXPECT_EQ(2 * mult.calls, report.get(ProfiledRegion::MP).calls);
+	EXPECT_EQ(0u, report.get(ProfiledRegion::MFNN).calls);
+	EXPECT_LT(0.0, report.get(ProfiledRegion::MS).bytes);
+	EXPECT_LE(report.get(ProfiledRegion::MS).seconds, report.wallTime);
+
+	// Traffic of Mult is the one of the operators it applies.
+	double operatorBytes{ 0.0 };
+	for (auto r : { ProfiledRegion::MS, ProfiledRegion::MFN, ProfiledRegion::MFNN, ProfiledRegion::MP, ProfiledRegion::OtherOperators }) {
+		operatorBytes += report.get(r).bytes;
+	}
+	EXPECT_LT(0.0, mult.bytes);
+	EXPECT_NEAR(operatorBytes, mult.bytes, 1e-9 * operatorBytes);
+
+	std::ifstream in{ reportFile };
+	ASSERT_TRUE(in.good());
+	const std::string json{ std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+	for (const auto& name : { "\"wallTime\"", "\"peakMemoryBytes\"", "\"mult\"", "\"rkUpdate\"", "\"MFNN\"", "\"dofsPerSecond\"" }) {
+		EXPECT_NE(std::string::npos, json.find(name));
+	}
+}
+
+TEST_F(TestSolver1D, performanceReport_isKeptPerSolver)
+{
+	maxwell::Solver first{
+		buildModel(),
+		Probes{},
+		buildGaussianInitialField(E, Y),
+		SolverOptions{}.setTimeStep(2.5e-3).setFinalTime(0.05)
+	};
+	first.run();
+	const auto multCalls{ first.getPerformanceReport().get(ProfiledRegion::Mult).calls };
+
+	maxwell::Solver second{
+		buildModel(),
+		Probes{},
+		buildGaussianInitialField(E, Y),
+		SolverOptions{}.setTimeStep(2.5e-3).setFinalTime(0.1)
+	};
+	second.run();
+
+	const auto report{ first.getPerformanceReport() };
+	EXPECT_EQ(multCalls, report.get(ProfiledRegion::Mult).calls);
+	EXPECT_EQ(1u, report.get(ProfiledRegion::Assembly).calls);
+	EXPECT_LT(multCalls, second.getPerformanceReport().get(ProfiledRegion::Mult).calls);
+}
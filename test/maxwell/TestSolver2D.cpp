@@ -1,7 +1,13 @@
 #include "gtest/gtest.h"
 
+#include <atomic>
+#include <filesystem>
+#include <thread>
+
 #include "AnalyticalFunctions2D.h"
 #include "SourceFixtures.h"
+#include "TemporaryDirectory.h"
+#include "maxwell/OperatorCache.h"
 #include "maxwell/Solver.h"
 
 using namespace maxwell;
@@ -397,4 +403,392 @@ TEST_F(TestSolver2D, quadraticMesh)
 //
 //	solver.run();
 //
-//}
\ No newline at end of file
+//}
+namespace {
+
+// Single file written to the cache directory, or throws.
+std::filesystem::path getOnlyCacheFile(const fixtures::TemporaryDirectory& dir)
+{
+	std::vector<std::filesystem::path> files;
+	for (const auto& entry : std::filesystem::directory_iterator(dir.path())) {
+		files.push_back(entry.path());
+	}
+	if (files.size() != 1) {
+		throw std::runtime_error("Expected a single operator cache file.");
+	}
+	return files.front();
+}
+
+}
+
+TEST_F(TestSolver2D, operatorCache_loadedOperatorsMatchAssembled)
+{
+	fixtures::TemporaryDirectory dir;
+	auto opts{ SolverOptions{}.setOrder(2) };
+	maxwell::Solver assembled{ buildModel(), Probes{}, buildGaussianInitialField(E, Z, 0.1, 0.5, mfem::Vector({0.5,0.5})), opts };
+
+	opts.evolutionOperatorOptions.operatorCacheDirectory = dir.path();
+	maxwell::Solver first{ buildModel(), Probes{}, buildGaussianInitialField(E, Z, 0.1, 0.5, mfem::Vector({0.5,0.5})), opts };
+	const auto cacheFile{ getOnlyCacheFile(dir) };
+	const auto written{ std::filesystem::last_write_time(cacheFile) };
+
+	maxwell::Solver cached{ buildModel(), Probes{}, buildGaussianInitialField(E, Z, 0.1, 0.5, mfem::Vector({0.5,0.5})), opts };
+	// A hit reads the file without writing it again.
+	EXPECT_EQ(cacheFile, getOnlyCacheFile(dir));
+	EXPECT_EQ(written, std::filesystem::last_write_time(cacheFile));
+
+	Vector x{ assembled.getFEEvol()->Width() };
+	x.Randomize(1);
+	Vector yAssembled{ x.Size() }, yCached{ x.Size() };
+	assembled.getFEEvol()->Mult(x, yAssembled);
+	cached.getFEEvol()->Mult(x, yCached);
+
+	yCached -= yAssembled;
+	EXPECT_EQ(0.0, yCached.Normlinf());
+}
+
+TEST_F(TestSolver2D, operatorCache_sharedOperatorsMatchAssembled)
+{
+	fixtures::TemporaryDirectory dir;
+	auto opts{ SolverOptions{}.setOrder(3) };
+	maxwell::Solver assembled{ buildModel(), Probes{}, buildGaussianInitialField(E, Z, 0.1, 0.5, mfem::Vector({0.5,0.5})), opts };
+
+	opts.evolutionOperatorOptions.operatorCacheDirectory = dir.path();
+	opts.evolutionOperatorOptions.shareCachedOperators = true;
+	maxwell::Solver first{ buildModel(), Probes{}, buildGaussianInitialField(E, Z, 0.1, 0.5, mfem::Vector({0.5,0.5})), opts };
+	const auto cacheFile{ getOnlyCacheFile(dir) };
+	const auto written{ std::filesystem::last_write_time(cacheFile) };
+
+	maxwell::Solver shared{ buildModel(), Probes{}, buildGaussianInitialField(E, Z, 0.1, 0.5, mfem::Vector({0.5,0.5})), opts };
+	EXPECT_EQ(cacheFile, getOnlyCacheFile(dir));
+	EXPECT_EQ(written, std::filesystem::last_write_time(cacheFile));
+
+	Vector x{ assembled.getFEEvol()->Width() };
+	x.Randomize(1);
+	Vector yAssembled{ x.Size() }, yFirst{ x.Size() }, yShared{ x.Size() };
+	assembled.getFEEvol()->Mult(x, yAssembled);
+	first.getFEEvol()->Mult(x, yFirst);
+	shared.getFEEvol()->Mult(x, yShared);
+
+	yFirst -= yAssembled;
+	yShared -= yAssembled;
+	EXPECT_EQ(0.0, yFirst.Normlinf());
+	EXPECT_EQ(0.0, yShared.Normlinf());
+}
+
+TEST_F(TestSolver2D, operatorCache_truncatedFileIsReassembled)
+{
+	fixtures::TemporaryDirectory dir;
+	auto opts{ SolverOptions{}.setOrder(2) };
+	opts.evolutionOperatorOptions.operatorCacheDirectory = dir.path();
+	maxwell::Solver first{ buildModel(), Probes{}, buildGaussianInitialField(E, Z, 0.1, 0.5, mfem::Vector({0.5,0.5})), opts };
+	const auto cacheFile{ getOnlyCacheFile(dir) };
+	const auto size{ std::filesystem::file_size(cacheFile) };
+
+	// The header is kept, so only reading the arrays finds the file is short.
+	std::filesystem::resize_file(cacheFile, size / 2);
+	std::unique_ptr<maxwell::Solver> reassembled;
+	ASSERT_NO_THROW(reassembled = std::make_unique<maxwell::Solver>(
+		buildModel(), Probes{}, buildGaussianInitialField(E, Z, 0.1, 0.5, mfem::Vector({0.5,0.5})), opts));
+	EXPECT_EQ(size, std::filesystem::file_size(getOnlyCacheFile(dir)));
+
+	Vector x{ first.getFEEvol()->Width() };
+	x.Randomize(1);
+	Vector yFirst{ x.Size() }, yReassembled{ x.Size() };
+	first.getFEEvol()->Mult(x, yFirst);
+	reassembled->getFEEvol()->Mult(x, yReassembled);
+
+	yReassembled -= yFirst;
+	EXPECT_EQ(0.0, yReassembled.Normlinf());
+}
+
+TEST_F(TestSolver2D, operatorCache_concurrentBuildsWithColdCache)
+{
+	Mesh mesh{ Mesh::MakeCartesian2D(3, 3, Element::Type::TRIANGLE) };
+	DG_FECollection fec{ 2, 2, BasisType::GaussLobatto };
+	FiniteElementSpace fes{ &mesh, &fec };
+	const auto model{ buildModel() };
+	auto assembleMass = [&]() {
+		auto res{ std::make_unique<BilinearForm>(&fes) };
+		res->AddDomainIntegrator(new MassIntegrator);
+		res->Assemble();
+		res->Finalize();
+		return res;
+	};
+	const auto reference{ assembleMass() };
+	Vector x{ fes.GetVSize() }, yReference{ fes.GetVSize() };
+	x.Randomize(1);
+	reference->Mult(x, yReference);
+
+	// Builds start together on an empty directory, so they all miss and write the same file.
+	const int builds{ 4 };
+	for (int round = 0; round < 8; round++) {
+		fixtures::TemporaryDirectory dir;
+		MaxwellEvolOptions opts;
+		opts.operatorCacheDirectory = dir.path();
+		opts.shareCachedOperators = true;
+
+		// Mappings outlive the operators using them in place.
+		std::vector<std::unique_ptr<MappedFile>> stores(builds);
+		std::vector<FiniteElementOperator> assembled, ops(builds);
+		for (int t = 0; t < builds; t++) {
+			assembled.push_back(assembleMass());
+		}
+		std::atomic<int> failures{ 0 };
+		std::vector<std::thread> threads;
+		for (int t = 0; t < builds; t++) {
+			threads.emplace_back([&, t]() {
+				try {
+					stores[t] = buildCachedOperators("concurrent", { &ops[t] }, fes, model, opts, [&, t]() { ops[t] = std::move(assembled[t]); });
+				}
+				catch (const std::exception&) {
+					failures++;
+				}
+			});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+
+		ASSERT_EQ(0, failures.load());
+		// No temporary file is left behind.
+		EXPECT_NO_THROW(getOnlyCacheFile(dir));
+		for (int t = 0; t < builds; t++) {
+			ASSERT_NE(nullptr, stores[t]);
+			Vector y{ x.Size() };
+			ops[t]->Mult(x, y);
+			y -= yReference;
+			EXPECT_EQ(0.0, y.Normlinf());
+		}
+	}
+}
+
+TEST_F(TestSolver2D, pml_absorbsOutgoingPulse)
+{
+	auto buildPMLModel = [this](bool withPML) {
+		auto mesh{ Mesh::MakeCartesian2D(10, 10, Element::Type::QUADRILATERAL, false, 2.0, 2.0) };
+		Vector center;
+		for (int e = 0; e < mesh.GetNE(); e++) {
+			mesh.GetElementCenter(e, center);
+			if (center[0] < 0.4 || center[0] > 1.6 || center[1] < 0.4 || center[1] > 1.6) {
+				mesh.SetAttribute(e, 2);
+			}
+		}
+		mesh.SetAttributes();
+		return Model(
+			mesh,
+			AttributeToMaterial{ {1, Material{1.0, 1.0}}, {2, Material{1.0, 1.0}} },
+			buildAttrToBdrMap2D(BdrCond::PEC, BdrCond::PEC, BdrCond::PEC, BdrCond::PEC),
+			withPML ? AttributeToPML{ {2, PMLRegion{}} } : AttributeToPML{}
+		);
+	};
+
+	Probes probes;
+	probes.energyProbes = { EnergyProbe{ {1} } };
+	probes.visSteps = 100;
+	const auto opts{ SolverOptions{}.setTimeStep(5e-4).setFinalTime(3.0).setOrder(3) };
+
+	maxwell::Solver pec{ buildPMLModel(false), probes, buildGaussianInitialField(E, Z, 0.1, 1.0, mfem::Vector({1.0,1.0})), opts };
+	maxwell::Solver pml{ buildPMLModel(true), probes, buildGaussianInitialField(E, Z, 0.1, 1.0, mfem::Vector({1.0,1.0})), opts };
+	pec.run();
+	pml.run();
+
+	const auto& pecEnergy{ pec.getEnergyProbe(0).getEnergyMovie() };
+	const auto& pmlEnergy{ pml.getEnergyProbe(0).getEnergyMovie() };
+	const auto initial{ pmlEnergy.begin()->second.total() };
+	EXPECT_NEAR(initial, pecEnergy.begin()->second.total(), 1e-12);
+	EXPECT_LT(pmlEnergy.rbegin()->second.total(), 1e-2 * initial);
+	EXPECT_LT(pmlEnergy.rbegin()->second.total(), 1e-1 * pecEnergy.rbegin()->second.total());
+}
+
+TEST_F(TestSolver2D, pml_interleavedLayoutsMatchBlocked)
+{
+	Mesh mesh{ Mesh::MakeCartesian2D(8, 8, Element::Type::QUADRILATERAL, false, 2.0, 2.0) };
+	Vector center;
+	for (int e = 0; e < mesh.GetNE(); e++) {
+		mesh.GetElementCenter(e, center);
+		if (center[0] < 0.5 || center[0] > 1.5 || center[1] < 0.5 || center[1] > 1.5) {
+			mesh.SetAttribute(e, 2);
+		}
+	}
+	mesh.SetAttributes();
+
+	auto buildSolver = [&](const FieldsLayout& layout) {
+		return std::make_unique<maxwell::Solver>(
+			Model(
+				mesh,
+				AttributeToMaterial{ {1, Material{1.0, 1.0}}, {2, Material{1.0, 1.0}} },
+				buildAttrToBdrMap2D(BdrCond::PEC, BdrCond::PEC, BdrCond::PEC, BdrCond::PEC),
+				AttributeToPML{ {2, PMLRegion{}} }
+			),
+			Probes{},
+			buildGaussianInitialField(E, Z, 0.1, 1.0, mfem::Vector({1.0,1.0})),
+			SolverOptions{}.setTimeStep(1e-3).setFinalTime(0.8).setOrder(2).setFieldsLayout(layout)
+		);
+	};
+
+	// The pulse reaches the layer, so its auxiliary fields take part in the result.
+	const auto reference{ buildSolver(FieldsLayout::Blocked) };
+	reference->run();
+	for (const auto& layout : { FieldsLayout::InterleavedByNode, FieldsLayout::InterleavedByElement }) {
+		const auto solver{ buildSolver(layout) };
+		solver->run();
+		const auto& fields{ solver->getFields() };
+		for (int i = 0; i < fields.E[Z].Size(); i++) {
+			EXPECT_NEAR(reference->getFields().E[Z][i], fields.E[Z][i], 1e-12);
+		}
+	}
+}
+
+TEST_F(TestSolver2D, elementOrdering_keepsFieldsAndReducesBandwidth)
+{
+	// Shuffled elements, so the initial numbering has no locality.
+	Mesh mesh{ Mesh::MakeCartesian2D(8, 8, Element::Type::QUADRILATERAL) };
+	Array<int> shuffle(mesh.GetNE());
+	for (int e = 0; e < shuffle.Size(); e++) {
+		shuffle[e] = (37 * e) % shuffle.Size();
+	}
+	mesh.ReorderElements(shuffle);
+
+	auto buildSolver = [&](const ElementOrdering& ordering) {
+		return std::make_unique<maxwell::Solver>(
+			Model(mesh, AttributeToMaterial{}, buildAttrToBdrMap2D(BdrCond::PEC, BdrCond::PEC, BdrCond::PEC, BdrCond::PEC)),
+			Probes{ { PointsProbe{ E, Z, Points{ {0.3, 0.4}, {0.71, 0.52} } } } },
+			buildGaussianInitialField(E, Z, 0.1, 1.0, mfem::Vector({ 0.5, 0.5 })),
+			SolverOptions{}.setFinalTime(0.2).setElementOrdering(ordering)
+		);
+	};
+
+	const auto reference{ buildSolver(ElementOrdering::None) };
+	reference->run();
+	const auto& expected{ reference->getPointsProbe(0).getFieldMovie() };
+
+	for (const auto& ordering : { ElementOrdering::Hilbert, ElementOrdering::Morton, ElementOrdering::ReverseCuthillMcKee }) {
+		// Every element gets exactly one new index.
+		auto permutation{ buildElementOrdering(mesh, ordering) };
+		ASSERT_EQ(mesh.GetNE(), permutation.Size());
+		permutation.Sort();
+		for (int e = 0; e < permutation.Size(); e++) {
+			EXPECT_EQ(e, permutation[e]);
+		}
+
+		const auto solver{ buildSolver(ordering) };
+		const auto& report{ solver->getElementOrderingReport() };
+		EXPECT_EQ(reference->getElementOrderingReport().bandwidthBefore, report.bandwidthBefore);
+		if (ordering == ElementOrdering::ReverseCuthillMcKee) {
+			EXPECT_LT(report.bandwidthAfter, report.bandwidthBefore);
+		}
+
+		solver->run();
+		const auto& movie{ solver->getPointsProbe(0).getFieldMovie() };
+		ASSERT_EQ(expected.size(), movie.size());
+		for (const auto& frame : movie) {
+			const auto& values{ expected.at(frame.first) };
+			for (std::size_t i{ 0 }; i < values.size(); i++) {
+				EXPECT_NEAR(values[i], frame.second[i], 1e-10);
+			}
+		}
+	}
+}
+
+TEST_F(TestSolver2D, fieldsLayout_interleavedLayoutsMatchBlocked)
+{
+	Mesh mesh{ Mesh::MakeCartesian2D(6, 6, Element::Type::TRIANGLE) };
+
+	auto buildSolver = [&](const FieldsLayout& layout) {
+		return std::make_unique<maxwell::Solver>(
+			Model(mesh, AttributeToMaterial{}, buildAttrToBdrMap2D(BdrCond::PEC, BdrCond::SMA, BdrCond::PEC, BdrCond::SMA)),
+			Probes{ { PointsProbe{ E, Z, Points{ {0.3, 0.4}, {0.71, 0.52} } } } },
+			buildGaussianInitialField(E, Z, 0.1, 1.0, mfem::Vector({ 0.5, 0.5 })),
+			SolverOptions{}.setFinalTime(0.2).setFieldsLayout(layout)
+		);
+	};
+
+	const auto reference{ buildSolver(FieldsLayout::Blocked) };
+	reference->run();
+	const auto& expected{ reference->getPointsProbe(0).getFieldMovie() };
+
+	for (const auto& layout : { FieldsLayout::InterleavedByNode, FieldsLayout::InterleavedByElement }) {
+		const auto solver{ buildSolver(layout) };
+		solver->run();
+
+		const auto& frame{ solver->getPointsProbe(0).getFieldMovie().rbegin()->second };
+		const auto& expectedFrame{ expected.rbegin()->second };
+		ASSERT_EQ(expectedFrame.size(), frame.size());
+		for (std::size_t i{ 0 }; i < frame.size(); i++) {
+			EXPECT_NEAR(expectedFrame[i], frame[i], 1e-12);
+		}
+		const auto& fields{ solver->getFields() };
+		EXPECT_NEAR(reference->getFields().getNorml2(), fields.getNorml2(), 1e-12);
+		for (int i = 0; i < fields.E[Z].Size(); i++) {
+			EXPECT_NEAR(reference->getFields().E[Z][i], fields.E[Z][i], 1e-12);
+		}
+	}
+}
+
+TEST_F(TestSolver2D, totalFieldScatteredField_nonConvexSurface)
+{
+	// U shaped total field region, whose notch is outside. The centroid of
+	// its surface lies in the notch, so the surface is not star shaped around it.
+	const int n{ 20 };
+	auto isInside = [&](int i, int j) {
+		const auto inU{ i >= 4 && i < 16 && j >= 4 && j < 16 };
+		const auto inNotch{ i >= 8 && i < 12 && j >= 8 };
+		return inU && !inNotch;
+	};
+
+	Mesh mesh{ 2, (n + 1) * (n + 1), n * n, 4 * n + 4 * n };
+	for (int j = 0; j <= n; j++) {
+		for (int i = 0; i <= n; i++) {
+			mesh.AddVertex(i / (double) n, j / (double) n);
+		}
+	}
+	auto vertex = [&](int i, int j) { return j * (n + 1) + i; };
+	for (int j = 0; j < n; j++) {
+		for (int i = 0; i < n; i++) {
+			mesh.AddQuad(vertex(i, j), vertex(i + 1, j), vertex(i + 1, j + 1), vertex(i, j + 1));
+		}
+	}
+	for (int k = 0; k < n; k++) {
+		mesh.AddBdrSegment(vertex(k, 0), vertex(k + 1, 0), 1);
+		mesh.AddBdrSegment(vertex(n, k), vertex(n, k + 1), 1);
+		mesh.AddBdrSegment(vertex(k + 1, n), vertex(k, n), 1);
+		mesh.AddBdrSegment(vertex(0, k + 1), vertex(0, k), 1);
+	}
+	for (int j = 0; j < n; j++) {
+		for (int i = 0; i < n; i++) {
+			if (i + 1 < n && isInside(i, j) != isInside(i + 1, j)) {
+				mesh.AddBdrSegment(vertex(i + 1, j), vertex(i + 1, j + 1), 2);
+			}
+			if (j + 1 < n && isInside(i, j) != isInside(i, j + 1)) {
+				mesh.AddBdrSegment(vertex(i, j + 1), vertex(i + 1, j + 1), 2);
+			}
+		}
+	}
+	mesh.FinalizeMesh();
+
+	Probes probes{ { PointsProbe{ E, Z, Points{ {0.3, 0.5}, {0.5, 0.7}, {0.1, 0.5} } } } };
+	probes.visSteps = 10;
+
+	Sources sources;
+	sources.push_back(std::make_unique<Planewave>(
+		Vector({ 0.0, 0.0, 1.0 }), Vector({ 1.0, 0.0, 0.0 }), GaussianPulse{ 0.1, 0.5 }, std::vector<Attribute>{ 2 }
+	));
+
+	maxwell::Solver solver{
+		Model(mesh, AttributeToMaterial{}, AttributeToBoundary{ {1, BdrCond::SMA} }),
+		probes,
+		sources,
+		SolverOptions{}.setTimeStep(5e-4).setFinalTime(1.5).setOrder(3)
+	};
+	solver.run();
+
+	// The pulse reaches x = 0.3 at t = 0.8 and never enters the notch nor the outer region.
+	double totalMax{ 0.0 }, scatteredMax{ 0.0 };
+	for (const auto& frame : solver.getPointsProbe(0).getFieldMovie()) {
+		totalMax = std::max(totalMax, frame.second[0]);
+		scatteredMax = std::max({ scatteredMax, std::abs(frame.second[1]), std::abs(frame.second[2]) });
+	}
+	EXPECT_NEAR(1.0, totalMax, 5e-2);
+	EXPECT_GT(5e-2, scatteredMax);
+}
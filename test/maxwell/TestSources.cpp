@@ -23,3 +23,63 @@ TEST_F(TestSources, negNormalizationInput)
 }
 
 
+
+TEST_F(TestSources, planewaveIncidentFields)
+{
+	Planewave pw{ Vector({ 0.0, 0.0, 2.0 }), Vector({ 3.0, 0.0, 0.0 }), GaussianPulse{ 1.0, 0.0 }, { 1 } };
+
+	EXPECT_EQ(2.0, pw.getAmplitude(E, Z));
+	EXPECT_EQ(-2.0, pw.getAmplitude(H, Y));
+	EXPECT_EQ(0.0, pw.getAmplitude(H, X));
+	EXPECT_NEAR(0.5, pw.getRetardedTime(Vector({ 1.0, 7.0 }), 1.5), 1e-12);
+}
+
+TEST_F(TestSources, planewaveInvalidInputs)
+{
+	ASSERT_ANY_THROW(Planewave(Vector({ 1.0, 0.0, 0.0 }), Vector({ 1.0, 0.0, 0.0 }), GaussianPulse{ 1.0, 0.0 }, { 1 }));
+	ASSERT_ANY_THROW(Planewave(Vector({ 0.0, 1.0, 0.0 }), Vector({ 1.0, 0.0, 0.0 }), GaussianPulse{ 1.0, 0.0 }, {}));
+}
+
+TEST_F(TestSources, waveforms)
+{
+	EXPECT_NEAR(std::exp(-0.5), GaussianPulse(2.0, 1.0).eval(3.0), 1e-12);
+	EXPECT_NEAR(0.0, ModulatedGaussianPulse(2.0, 1.0, 0.25).eval(1.0), 1e-12);
+	EXPECT_NEAR(std::exp(-0.125), ModulatedGaussianPulse(2.0, 1.0, 0.25).eval(2.0), 1e-12);
+
+	RampedSinusoid sinusoid{ 0.25, 2.0 };
+	EXPECT_EQ(0.0, sinusoid.eval(-1.0));
+	EXPECT_NEAR(0.5, sinusoid.eval(1.0), 1e-12);
+	EXPECT_NEAR(-1.0, sinusoid.eval(3.0), 1e-12);
+
+	SampledWaveform sampled{ { 0.0, 1.0, 3.0 }, { 0.0, 2.0, -2.0 } };
+	EXPECT_EQ(0.0, sampled.eval(-0.5));
+	EXPECT_NEAR(1.0, sampled.eval(0.5), 1e-12);
+	EXPECT_NEAR(0.0, sampled.eval(2.0), 1e-12);
+	EXPECT_NEAR(-2.0, sampled.eval(3.0), 1e-12);
+	EXPECT_EQ(0.0, sampled.eval(3.5));
+	ASSERT_ANY_THROW(SampledWaveform({ 1.0, 0.0 }, { 0.0, 1.0 }));
+}
+
+TEST_F(TestSources, addValuesMatchesPointwiseEvaluation)
+{
+	NodalPositions positions(4, 3);
+	Vector offset{ 4 };
+	for (int i = 0; i < positions.Height(); i++) {
+		for (int d = 0; d < positions.Width(); d++) {
+			positions(i, d) = 0.1 * (i + 1) + 0.3 * d;
+		}
+		offset[i] = i;
+	}
+
+	const GaussianInitialField gaussian{ E, Y, 0.5, 2.0, Position({ 0.2, 0.4, 0.1 }) };
+	const SinusoidalInitialField sinusoidal{ H, Y, { 1, 2, 3 }, { 1.0, 0.5, 2.0 }, Position({ 0.0, 0.0, 0.0 }) };
+	for (const Source* source : std::vector<const Source*>{ &gaussian, &sinusoidal }) {
+		Vector values{ offset };
+		source->addValues(positions, values);
+		Vector pos{ 3 };
+		for (int i = 0; i < positions.Height(); i++) {
+			positions.GetRow(i, pos);
+			EXPECT_NEAR(offset[i] + source->eval3D(pos), values[i], 1e-12);
+		}
+	}
+}